@@ -60,6 +60,10 @@ class LMI_SO AccountValue
 
     double RunAV                ();
 
+    void RestrictRunBases    (std::vector<mcenum_run_basis> const&);
+
+    void ReviseInput         (Input const&);
+
     void SetDebugFilename    (std::string const&);
 
     void SolveSetPmts // Antediluvian.
@@ -124,6 +128,7 @@ class LMI_SO AccountValue
     LedgerInvariant& InvariantValues();
     LedgerVariant  & VariantValues  ();
 
+    void   SetInitialState         ();
     double RunOneCell              (mcenum_run_basis);
     double RunOneBasis             (mcenum_run_basis);
     double RunAllApplicableBases   ();
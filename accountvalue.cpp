@@ -25,6 +25,7 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "contains.hpp"
 #include "database.hpp"
 #include "dbnames.hpp"
 #include "death_benefits.hpp"
@@ -127,6 +128,23 @@ AccountValue::AccountValue(Input const& input)
     NetPmts    .resize(12);
 }
 
+//============================================================================
+void AccountValue::ReviseInput(Input const& input)
+{
+    BasicValues::ReviseInput(yare_input(Input::consummate(input)));
+    ledger_.reset(new Ledger(BasicValues::GetLength(), BasicValues::ledger_type(), BasicValues::nonillustrated(), BasicValues::no_can_issue(), false));
+    ledger_invariant_.reset(new LedgerInvariant(BasicValues::GetLength()));
+    ledger_variant_  .reset(new LedgerVariant  (BasicValues::GetLength()));
+    RunBasis_   = mce_run_gen_curr_sep_full;
+    GenBasis_   = mce_gen_curr;
+    SepBasis_   = mce_sep_full;
+    pmt_mode    = mce_annual;
+    OldDBOpt    = mce_option1;
+    YearsDBOpt  = mce_option1;
+    GrossPmts  .assign(12, 0.0);
+    NetPmts    .assign(12, 0.0);
+}
+
 //============================================================================
 std::shared_ptr<Ledger const> AccountValue::ledger_from_av() const
 {
@@ -143,6 +161,12 @@ double AccountValue::RunAV()
     return RunAllApplicableBases();
 }
 
+//============================================================================
+void AccountValue::RestrictRunBases(std::vector<mcenum_run_basis> const& wanted)
+{
+    ledger_->RestrictRunBases(wanted);
+}
+
 //============================================================================
 double AccountValue::RunOneBasis(mcenum_run_basis TheBasis)
 {
@@ -194,13 +218,20 @@ double AccountValue::RunAllApplicableBases()
     RunOneBasis(run_basis);
     ledger_->SetOneLedgerVariant(run_basis, VariantValues());
 
+    // Other bases may have been omitted by RestrictRunBases().
     run_basis = mce_run_gen_guar_sep_full;
-    RunOneBasis(run_basis);
-    ledger_->SetOneLedgerVariant(run_basis, VariantValues());
+    if(contains(ledger_->GetRunBases(), run_basis))
+        {
+        RunOneBasis(run_basis);
+        ledger_->SetOneLedgerVariant(run_basis, VariantValues());
+        }
 
     run_basis = mce_run_gen_mdpt_sep_full;
-    RunOneBasis(run_basis);
-    ledger_->SetOneLedgerVariant(run_basis, VariantValues());
+    if(contains(ledger_->GetRunBases(), run_basis))
+        {
+        RunOneBasis(run_basis);
+        ledger_->SetOneLedgerVariant(run_basis, VariantValues());
+        }
 
     return z;
 }
@@ -32,15 +32,21 @@
 
 #include <boost/filesystem/convenience.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 
 #include <algorithm>                    // std::max(), std::min()
 #include <cctype>                       // std::toupper()
 #include <climits>                      // CHAR_BIT
 #include <cstdint>
+#include <ctime>                        // std::time_t
 #include <ios>
 #include <istream>
 #include <limits>
+#include <map>
+#include <memory>                       // std::shared_ptr
+#include <mutex>
+#include <utility>                      // std::make_pair()
 
 namespace
 {
@@ -565,6 +571,97 @@ std::vector<double> actuarial_table::specific_values
     return v;
 }
 
+namespace
+{
+/// Cache of tables, keyed by filename and table number.
+///
+/// Motivation: Reading a table from file is far costlier than
+/// extracting particular values from it, yet every cell in a census
+/// typically reads the same few tables--once for each gender and
+/// smoking status that enters into a blend. Cells that share a rate
+/// class thus share one parsed instance of each table, and only the
+/// inexpensive value lookup is repeated for each issue age and
+/// reentry method. Blending (by gender and smoking) is a weighted
+/// sum of such lookups, which is no costlier than copying a cached
+/// blended vector would be, so it isn't cached separately.
+///
+/// As with class file_cache (q.v.), each table is reloaded if the
+/// write time of its '.dat' file has changed, and the cache persists
+/// until the program terminates. Tables are never modified after
+/// construction, so they are shared as shared_ptr<T const>.
+///
+/// If the '.dat' file doesn't exist, the table is constructed anyway,
+/// uncached, so that the ctor's diagnostics are preserved.
+///
+/// Retrieval is serialized by a mutex, as for class file_cache, so
+/// that cells can be harmonized and run concurrently.
+
+class table_cache final
+{
+    using key_type = std::pair<std::string,int>;
+
+  public:
+    using retrieved_type = std::shared_ptr<actuarial_table const>;
+
+    static table_cache& instance()
+        {
+        static table_cache z;
+        return z;
+        }
+
+    retrieved_type retrieve_or_reload
+        (std::string const& filename
+        ,int                table_number
+        )
+        {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        fs::path data_path(filename);
+        data_path = fs::change_extension(data_path, ".dat");
+        if(!fs::exists(data_path))
+            {
+            return retrieved_type
+                (new actuarial_table(filename, table_number)
+                );
+            }
+        std::time_t const write_time = fs::last_write_time(data_path);
+
+        key_type const key(filename, table_number);
+        auto i = cache_.lower_bound(key);
+        if
+            (  cache_.end() == i
+            || key          != i->first
+            || write_time   != i->second.write_time
+            )
+            {
+            // Construct before inserting because ctor might throw.
+            retrieved_type value(new actuarial_table(filename, table_number));
+
+            i = cache_.insert(i, std::make_pair(key, record()));
+            i->second.data = value;
+            i->second.write_time = write_time;
+            }
+
+        LMI_ASSERT(i->second.data);
+        return i->second.data;
+        }
+
+  private:
+    table_cache() = default;
+    table_cache(table_cache const&) = delete;
+    table_cache& operator=(table_cache const&) = delete;
+
+    struct record
+    {
+        retrieved_type data;
+        std::time_t    write_time;
+    };
+
+    std::map<key_type,record> cache_;
+    std::mutex                mutex_;
+};
+} // Unnamed namespace.
+
 std::vector<double> actuarial_table_rates
     (std::string const& table_filename
     ,int                table_number
@@ -572,8 +669,11 @@ std::vector<double> actuarial_table_rates
     ,int                length
     )
 {
-    actuarial_table z(table_filename, table_number);
-    return z.values(issue_age, length);
+    auto const z = table_cache::instance().retrieve_or_reload
+        (table_filename
+        ,table_number
+        );
+    return z->values(issue_age, length);
 }
 
 std::vector<double> actuarial_table_rates_elaborated
@@ -586,8 +686,11 @@ std::vector<double> actuarial_table_rates_elaborated
     ,int                      reset_duration
     )
 {
-    actuarial_table z(table_filename, table_number);
-    return z.values_elaborated
+    auto const z = table_cache::instance().retrieve_or_reload
+        (table_filename
+        ,table_number
+        );
+    return z->values_elaborated
         (issue_age
         ,length
         ,method
@@ -175,6 +175,9 @@ class actuarial_table final
 
 /// Convenience function: read particular values from a table stored
 /// in the SOA table-manager format.
+///
+/// Tables are read through a cache, so that all cells that use a
+/// given table share a single parsed instance of it.
 
 std::vector<double> actuarial_table_rates
     (std::string const& table_filename
@@ -185,6 +188,8 @@ std::vector<double> actuarial_table_rates
 
 /// Convenience function: read particular values from a table stored
 /// in the SOA table-manager format, using a nondefault lookup method.
+///
+/// Like actuarial_table_rates(), this reads tables through a cache.
 
 std::vector<double> actuarial_table_rates_elaborated
     (std::string const&       table_filename
@@ -224,9 +224,20 @@ void mete()
     rates = actuarial_table(qx_ins, 256).values(10, 112);
 }
 
+void mete_cached()
+{
+    std::vector<double> rates;
+
+    rates = actuarial_table_rates(qx_cso,  42,  0, 100);
+    rates = actuarial_table_rates(qx_cso,  42, 35,  65);
+    rates = actuarial_table_rates(qx_ins, 256, 90,  32);
+    rates = actuarial_table_rates(qx_ins, 256, 10, 112);
+}
+
 void assay_speed()
 {
     std::cout << "  Speed test: " << TimeAnAliquot(mete) << '\n';
+    std::cout << "  Cached    : " << TimeAnAliquot(mete_cached) << '\n';
 }
 
 /// Test general preconditions.
@@ -315,6 +326,46 @@ void test_lookup_errors()
         );
 }
 
+/// Test the convenience functions, which read tables via a cache.
+///
+/// Results must be identical to those obtained by reading each table
+/// afresh, however often they're retrieved; and the cache mustn't
+/// suppress the diagnostics the ctor would give.
+
+void test_cached_lookup()
+{
+    for(int j = 0; j < 3; ++j)
+        {
+        BOOST_TEST
+            (   actuarial_table(qx_cso, 42).values(35, 65)
+            ==  actuarial_table_rates(qx_cso, 42, 35, 65)
+            );
+        BOOST_TEST
+            (   actuarial_table(qx_ins, 256).values(10, 112)
+            ==  actuarial_table_rates(qx_ins, 256, 10, 112)
+            );
+        BOOST_TEST
+            (   actuarial_table(qx_ins, 256).values_elaborated
+                    (45, 55, e_reenter_at_inforce_duration, 3, 0)
+            ==  actuarial_table_rates_elaborated
+                    (qx_ins, 256, 45, 55, e_reenter_at_inforce_duration, 3, 0)
+            );
+        }
+
+    BOOST_TEST_THROW
+        (actuarial_table_rates("nonexistent", 1, 0, 1)
+        ,std::runtime_error
+        ,"File 'nonexistent.ndx' is required but could not be found."
+         " Try reinstalling."
+        );
+
+    BOOST_TEST_THROW
+        (actuarial_table_rates(qx_cso, 42, 0, 101)
+        ,std::runtime_error
+        ,"Assertion '0 <= length && length <= 1 + max_age_ - issue_age' failed."
+        );
+}
+
 void test_e_reenter_never()
 {
     std::vector<double> rates;
@@ -609,6 +660,7 @@ int test_main(int, char*[])
 {
     test_precondition_failures();
     test_lookup_errors();
+    test_cached_lookup();
     test_e_reenter_never();
     test_e_reenter_at_inforce_duration();
     test_e_reenter_upon_rate_reset();
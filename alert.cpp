@@ -191,13 +191,19 @@ class alarum_buf
 ///
 /// Both 'failbit' [27.6.2.5.3/8] and 'badbit' [27.6.2.1/3] must be
 /// specified in the call to exceptions().
+///
+/// Each thread has its own streams, so that code running on a worker
+/// thread--e.g., validating census cells--can use alarum() to throw
+/// an exception without garbling another thread's message. Only the
+/// main thread should use the other alert streams, whose functions
+/// may interact with a GUI.
 
 template<typename T>
 inline std::ostream& alert_stream()
 {
     static_assert(std::is_base_of<alert_buf,T>::value, "");
-    static T buffer_;
-    static std::ostream stream_(&buffer_);
+    static thread_local T buffer_;
+    static thread_local std::ostream stream_(&buffer_);
     stream_.clear();
     stream_.exceptions(std::ios_base::failbit | std::ios_base::badbit);
     return stream_;
@@ -67,7 +67,10 @@
 #include "value_cast.hpp"
 
 #include <algorithm>                    // std::lower_bound(), std::swap()
+#include <functional>                   // std::function
 #include <map>
+#include <memory>                       // std::unique_ptr
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <type_traits>
@@ -514,9 +517,14 @@ MemberType const* member_cast(any_member<ClassType> const& member)
 
 // Definition of class MemberSymbolTable.
 
-// By its nature, this class is uncopyable: it holds a map of
-// pointers to member, which need to be initialized instead of copied
-// when a derived class is copied.
+// The names and types of a class's ascribed members are the same for
+// every instance, so they're kept in a single table for each class,
+// which the first instance builds as it ascribes its members. Each
+// instance binds those descriptors to itself only when one of its
+// members is first accessed by name. Thus, copying an object of a
+// derived class copies only its data members: its own bindings are
+// created anew when needed, because copied bindings would refer to
+// the original object's members.
 //
 // A do-nothing constructor is specified in order to prevent compilers
 // from warning of its absence. It's protected because this class
@@ -525,8 +533,7 @@ MemberType const* member_cast(any_member<ClassType> const& member)
 template<typename ClassType>
 class MemberSymbolTable
 {
-    typedef std::map<std::string, any_member<ClassType>> member_map_type;
-    typedef typename member_map_type::value_type member_pair_type;
+    typedef std::vector<any_member<ClassType>> member_vector_type;
 
   public:
     virtual ~MemberSymbolTable();
@@ -540,29 +547,78 @@ class MemberSymbolTable
 
   protected:
     MemberSymbolTable();
+    MemberSymbolTable(MemberSymbolTable const&);
+    MemberSymbolTable& operator=(MemberSymbolTable const&);
 
     template<typename ValueType, typename SameOrBaseClassType>
     void ascribe(std::string const&, ValueType SameOrBaseClassType::*);
 
   private:
-    MemberSymbolTable(MemberSymbolTable const&) = delete;
-    MemberSymbolTable& operator=(MemberSymbolTable const&) = delete;
+    struct member_descriptors
+    {
+        std::map<std::string,int>                                     index;
+        std::vector<std::function<any_member<ClassType>(ClassType*)>> binders;
+        std::vector<std::string>                                      names;
+        std::mutex                                                    mutex;
+    };
+
+    static member_descriptors& class_descriptors();
 
     [[noreturn]]
     void complain_that_no_such_member_is_ascribed(std::string const&) const;
 
-    member_map_type map_;
-    std::vector<std::string> member_names_;
+    int index_of(std::string const&) const;
+    member_vector_type& bound_members() const;
+
+    member_descriptors&                         descriptors_;
+    mutable std::unique_ptr<member_vector_type> members_;
+    mutable std::once_flag                      members_bound_;
 };
 
 // Implementation of class MemberSymbolTable.
 
+/// Each instance refers to the table of descriptors through a member,
+/// so that all instances use the same table even if they're created
+/// in different shared libraries, each of which might instantiate its
+/// own copy of class_descriptors()'s static object.
+
 template<typename ClassType>
-MemberSymbolTable<ClassType>::MemberSymbolTable() = default;
+MemberSymbolTable<ClassType>::MemberSymbolTable()
+    :descriptors_(class_descriptors())
+{
+}
+
+/// Copy ctor: binds nothing, because copied bindings would refer to
+/// the original object's members.
+
+template<typename ClassType>
+MemberSymbolTable<ClassType>::MemberSymbolTable(MemberSymbolTable const& z)
+    :descriptors_(z.descriptors_)
+{
+}
+
+/// Copy assignment: retains this object's bindings, which already
+/// refer to its own members.
+
+template<typename ClassType>
+MemberSymbolTable<ClassType>& MemberSymbolTable<ClassType>::operator=
+    (MemberSymbolTable const&
+    )
+{
+    return *this;
+}
 
 template<typename ClassType>
 MemberSymbolTable<ClassType>::~MemberSymbolTable() = default;
 
+template<typename ClassType>
+typename MemberSymbolTable<ClassType>::member_descriptors&
+MemberSymbolTable<ClassType>::class_descriptors()
+{
+    static member_descriptors z;
+    return z;
+}
+
 // operator[]() returns a known member; unlike std::map::operator[](),
 // it never adds a new pair to the map, and it complains if such an
 // addition is attempted.
@@ -584,31 +640,65 @@ void MemberSymbolTable<ClassType>::complain_that_no_such_member_is_ascribed
 }
 
 template<typename ClassType>
-any_member<ClassType>& MemberSymbolTable<ClassType>::operator[]
-    (std::string const& s
-    )
+int MemberSymbolTable<ClassType>::index_of(std::string const& s) const
 {
-    auto i = map_.find(s);
-    if(map_.end() == i)
+    std::map<std::string,int> const& index = descriptors_.index;
+    auto const i = index.find(s);
+    if(index.end() == i)
         {
         complain_that_no_such_member_is_ascribed(s);
         }
     return i->second;
 }
 
+/// Bind every ascribed member of this object, the first time any of
+/// them is requested. The table of descriptors is complete by then,
+/// because the constructor that ascribed them has returned.
+
+template<typename ClassType>
+typename MemberSymbolTable<ClassType>::member_vector_type&
+MemberSymbolTable<ClassType>::bound_members() const
+{
+    std::call_once
+        (members_bound_
+        ,[this] ()
+            {
+            ClassType* class_object = static_cast<ClassType*>
+                (const_cast<MemberSymbolTable<ClassType>*>(this)
+                );
+            auto const& binders = descriptors_.binders;
+            std::unique_ptr<member_vector_type> z(new member_vector_type);
+            z->reserve(binders.size());
+            for(auto const& i : binders)
+                {
+                z->push_back(i(class_object));
+                }
+            members_ = std::move(z);
+            }
+        );
+    return *members_;
+}
+
+template<typename ClassType>
+any_member<ClassType>& MemberSymbolTable<ClassType>::operator[]
+    (std::string const& s
+    )
+{
+    return bound_members()[index_of(s)];
+}
+
 template<typename ClassType>
 any_member<ClassType> const& MemberSymbolTable<ClassType>::operator[]
     (std::string const& s
     ) const
 {
-    auto const i = map_.find(s);
-    if(map_.end() == i)
-        {
-        complain_that_no_such_member_is_ascribed(s);
-        }
-    return i->second;
+    return bound_members()[index_of(s)];
 }
 
+/// Describe a member in the table shared by all instances. Only the
+/// first instance constructed actually adds anything to the table;
+/// later ones find each name already present.
+
 template<typename ClassType>
 template<typename ValueType, typename SameOrBaseClassType>
 void MemberSymbolTable<ClassType>::ascribe
@@ -633,11 +723,22 @@ void MemberSymbolTable<ClassType>::ascribe
         ,""
         );
 
-    ClassType* class_object = static_cast<ClassType*>(this);
-    map_.insert(member_pair_type(s, any_member<ClassType>(class_object, p2m)));
-    // TODO ?? This would appear to be O(N^2).
-    auto i = std::lower_bound(member_names_.begin(), member_names_.end(), s);
-    member_names_.insert(i, s);
+    member_descriptors& d = descriptors_;
+    std::lock_guard<std::mutex> lock(d.mutex);
+    if(d.index.count(s))
+        {
+        return;
+        }
+    d.index[s] = static_cast<int>(d.binders.size());
+    d.binders.push_back
+        ([p2m] (ClassType* class_object)
+            {
+            return any_member<ClassType>(class_object, p2m);
+            }
+        );
+    // This is O(N^2), but it's done only once for each class.
+    auto i = std::lower_bound(d.names.begin(), d.names.end(), s);
+    d.names.insert(i, s);
 }
 
 template<typename ClassType>
@@ -672,7 +773,7 @@ std::vector<std::string> const& MemberSymbolTable<ClassType>::member_names
     (
     ) const
 {
-    return member_names_;
+    return descriptors_.names;
 }
 
 /// Implementation of free function template member_state(), which
@@ -99,6 +99,9 @@ class LMI_SO BasicValues
     void Init();
     void GPTServerInit();
 
+    static bool IsRevisable(std::string const& input_field);
+    void ReviseInput(yare_input const&);
+
     int                   GetLength()                  const;
     int                   GetIssueAge()                const;
     int                   GetRetAge()                  const;
@@ -25,6 +25,7 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "contains.hpp"
 #include "database.hpp"
 #include "dbnames.hpp"
 #include "death_benefits.hpp"
@@ -137,6 +138,26 @@ void BasicValues::Init()
 // ProductData initialized to null pointers.
 }
 
+//============================================================================
+bool BasicValues::IsRevisable(std::string const& input_field)
+{
+    static std::vector<std::string> const revisable
+        {"CorporationPayment"
+        ,"GeneralAccountRate"
+        ,"Payment"
+        };
+    return contains(revisable, input_field);
+}
+
+//============================================================================
+void BasicValues::ReviseInput(yare_input const& revised)
+{
+    LMI_ASSERT(revised.IssueAge == yare_input_.IssueAge);
+    yare_input_ = revised;
+    InterestRates_.reset(new InterestRates(*this));
+    Outlay_       .reset(new modal_outlay (yare_input_));
+}
+
 //============================================================================
 double BasicValues::InvestmentManagementFee() const
 {
@@ -33,7 +33,7 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/path.hpp>
 
-#include <algorithm>                    // std::find()
+#include <unordered_map>
 
 namespace
 {
@@ -71,6 +71,23 @@ std::vector<std::string> const& product_names()
     return names;
 }
 
+/// Map each product name to its index in product_names().
+
+std::unordered_map<std::string,std::size_t> const& product_indices()
+{
+    typedef std::unordered_map<std::string,std::size_t> index_type;
+    static index_type const index = [] ()
+        {
+        index_type z(product_names().size());
+        for(std::size_t j = 0; j < product_names().size(); ++j)
+            {
+            z.insert({product_names()[j], j});
+            }
+        return z;
+        } ();
+    return index;
+}
+
 /// Default product name is "sample" if that product is available,
 /// else the name of the first product found.
 ///
@@ -122,13 +139,11 @@ bool ce_product_name::operator==(std::string const& s) const
 
 std::size_t ce_product_name::ordinal(std::string const& s)
 {
+    auto const i = product_indices().find(s);
     std::size_t v =
-            std::find
-                (product_names().begin()
-                ,product_names().end()
-                ,s
-                )
-        -   product_names().begin()
+          (product_indices().end() == i)
+        ? product_names().size()
+        : i->second
         ;
     if(v == product_names().size())
         {
@@ -27,6 +27,7 @@
 #include "alert.hpp"
 #include "assert_lmi.hpp"
 #include "census_view.hpp"
+#include "gzip_stream.hpp"
 #include "illustrator.hpp"              // default_cell()
 #include "miscellany.hpp"
 #include "wx_utility.hpp"
@@ -58,7 +59,7 @@ bool CensusDocument::OnCreate(wxString const& filename, long int flags)
     else
         {
         std::string f = ValidateAndConvertFilename(filename);
-        std::ifstream ifs(f.c_str());
+        std::ifstream ifs(f.c_str(), ios_in_binary());
         if(!ifs)
             {
             warning()
@@ -69,6 +70,7 @@ bool CensusDocument::OnCreate(wxString const& filename, long int flags)
                 ;
             return false;
             }
+        compressed_ = is_gzip_compressed(ifs);
         doc_.read(ifs);
         }
 
@@ -88,7 +90,16 @@ bool CensusDocument::DoSaveDocument(wxString const& filename)
 {
     std::string f = ValidateAndConvertFilename(filename);
     std::ofstream ofs(f.c_str(), ios_out_trunc_binary());
-    doc_.write(ofs);
+    if(compressed_ || has_gzip_extension(f))
+        {
+        gzip_ostream gz(ofs);
+        doc_.write(gz);
+        gz.finish();
+        }
+    else
+        {
+        doc_.write(ofs);
+        }
     if(!ofs)
         {
         warning() << "Unable to save '" << filename << "'." << LMI_FLUSH;
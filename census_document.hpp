@@ -53,6 +53,9 @@ class CensusDocument
 
     multiple_cell_document doc_;
 
+    /// A document read from a gzip-compressed file is saved compressed.
+    bool compressed_ {false};
+
     DECLARE_DYNAMIC_CLASS(CensusDocument)
 };
 
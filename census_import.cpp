@@ -0,0 +1,365 @@
+// Import a census from delimited text.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "census_import.hpp"
+
+#include "alert.hpp"
+#include "any_member.hpp"               // exact_cast()
+#include "assert_lmi.hpp"
+#include "calendar_date.hpp"
+#include "contains.hpp"
+#include "facets.hpp"                   // tab_is_not_whitespace_locale()
+#include "fenv_lmi.hpp"
+#include "tn_range_types.hpp"           // tnr_date
+#include "value_cast.hpp"
+
+#include <algorithm>                    // std::binary_search()
+#include <atomic>
+#include <cstddef>                      // std::size_t
+#include <exception>                    // std::exception_ptr
+#include <istream>                      // std::getline(), std::ws
+#include <memory>                       // std::unique_ptr
+#include <stdexcept>
+#include <thread>
+
+namespace
+{
+/// Number of lines read before any is parsed.
+
+std::size_t const rows_per_batch = 1024;
+
+/// Read a line, ignoring any terminal carriage return, then skip
+/// whitespace (but not tabs) so that blank lines are ignored.
+
+bool read_line(std::istream& is, std::string& line)
+{
+    if(!std::getline(is, line, '\n'))
+        {
+        return false;
+        }
+    if(!line.empty() && '\r' == line.back())
+        {
+        line.pop_back();
+        }
+    is >> std::ws;
+    return true;
+}
+} // Unnamed namespace.
+
+/// Read the header line, and derive the exemplar from it.
+///
+/// The stream is imbued with a locale in which tab isn't whitespace,
+/// so that empty tab-delimited fields aren't skipped.
+
+census_importer::census_importer
+    (std::istream&       is
+    ,Input        const& case_default
+    ,char                delimiter
+    )
+    :is_        (is)
+    ,delimiter_ (delimiter)
+    ,exemplar_  (case_default)
+{
+    is_.imbue(tab_is_not_whitespace_locale());
+    std::string line;
+    if(!read_line(is_, line))
+        {
+        alarum() << "Census data has no header line." << LMI_FLUSH;
+        }
+    headers_ = split_census_record(line, delimiter_);
+
+    std::vector<std::string> const& names = exemplar_.member_names();
+    for(auto const& i : headers_)
+        {
+        if(!std::binary_search(names.begin(), names.end(), i))
+            {
+            alarum()
+                << "Census column '"
+                << i
+                << "' is not the name of any input field."
+                << LMI_FLUSH
+                ;
+            }
+        is_date_.push_back(nullptr != exact_cast<tnr_date>(exemplar_[i]));
+        }
+
+    // Force 'UseDOB' prn. Pasting it as a column never makes sense.
+    if(contains(headers_, "UseDOB"))
+        {
+        warning() << "'UseDOB' is unnecessary and will be ignored." << std::flush;
+        }
+    bool const dob_pasted = contains(headers_, "DateOfBirth");
+    bool const age_pasted = contains(headers_, "IssueAge");
+    if(dob_pasted && age_pasted)
+        {
+        alarum()
+            << "Cannot paste both 'DateOfBirth' and 'IssueAge'."
+            << LMI_FLUSH
+            ;
+        }
+    else if(dob_pasted)
+        {
+        exemplar_["UseDOB"] = "Yes";
+        }
+    else if(age_pasted)
+        {
+        exemplar_["UseDOB"] = "No";
+        }
+    else
+        {
+        ; // Do nothing: neither age nor DOB pasted.
+        }
+}
+
+/// Modifiable copy of the case default, from which each cell is made.
+
+Input const& census_importer::exemplar() const
+{
+    return exemplar_;
+}
+
+/// Read every remaining line, passing each cell to 'sink'.
+///
+/// Returns the number of cells imported.
+///
+/// Parsing each line's values, reconciling the resulting cell, and
+/// realizing its sequences are done concurrently.
+///
+/// If any line is invalid, the exception it caused is rethrown after
+/// all preceding cells have been passed to 'sink', so the error that
+/// is reported is always the first one in the file.
+
+int census_importer::import_cells
+    (cell_sink const& sink
+    ,int              number_of_threads
+    )
+{
+    LMI_ASSERT(0 < number_of_threads);
+    int number_of_cells = 0;
+    std::vector<std::string> rows;
+    std::string line;
+    for(;;)
+        {
+        rows.clear();
+        while(rows.size() < rows_per_batch && read_line(is_, line))
+            {
+            rows.push_back(line);
+            }
+        if(rows.empty())
+            {
+            break;
+            }
+
+        std::vector<std::unique_ptr<Input>> cells(rows.size());
+        std::vector<std::exception_ptr> failures(rows.size());
+        std::atomic<std::size_t> next_row(0);
+        auto work = [&] (int thread_number)
+            {
+            // Initialize each new thread's floating-point environment
+            // as the main thread's was initialized.
+            if(0 != thread_number)
+                {
+                fenv_initialize();
+                }
+            for(std::size_t j = next_row++; j < rows.size(); j = next_row++)
+                {
+                try
+                    {
+                    cells[j].reset(new Input(exemplar_));
+                    int const line_number = 1 + number_of_cells + static_cast<int>(j);
+                    parse_row(*cells[j], line_number, rows[j]);
+                    cells[j]->Reconcile();
+                    cells[j]->RealizeAllSequenceInput();
+                    }
+                catch(...)
+                    {
+                    failures[j] = std::current_exception();
+                    }
+                }
+            };
+
+        std::vector<std::thread> threads;
+        for(int j = 1; j < number_of_threads; ++j)
+            {
+            threads.emplace_back(work, j);
+            }
+        work(0);
+        for(auto& t : threads)
+            {
+            t.join();
+            }
+
+        for(std::size_t j = 0; j < rows.size(); ++j)
+            {
+            if(failures[j])
+                {
+                std::rethrow_exception(failures[j]);
+                }
+            sink(*cells[j]);
+            cells[j].reset();
+            ++number_of_cells;
+            }
+        }
+    return number_of_cells;
+}
+
+/// Assign one line's values to a cell.
+///
+/// Lines are numbered as in the original paste implementation: the
+/// first line after the header is line one.
+
+void census_importer::parse_row
+    (Input&             cell
+    ,int                line_number
+    ,std::string const& line
+    ) const
+{
+    std::vector<std::string> values = split_census_record(line, delimiter_);
+    if(values.size() != headers_.size())
+        {
+        alarum()
+            << "Line #" << line_number << ": "
+            << "  (" << line << ") "
+            << "should have one value per column. "
+            << "Number of values: " << values.size() << "; "
+            << "number expected: " << headers_.size() << "."
+            << LMI_FLUSH
+            ;
+        }
+
+    for(std::size_t j = 0; j < headers_.size(); ++j)
+        {
+        if(is_date_[j])
+            {
+            static long int const jdn_min = calendar_date::gregorian_epoch_jdn;
+            static long int const jdn_max = calendar_date::last_yyyy_date_jdn;
+            static long int const ymd_min = JdnToYmd(jdn_t(jdn_min)).value();
+            static long int const ymd_max = JdnToYmd(jdn_t(jdn_max)).value();
+            long int z = value_cast<long int>(values[j]);
+            if(jdn_min <= z && z <= jdn_max)
+                {
+                ; // Do nothing: JDN is the default expectation.
+                }
+            else if(ymd_min <= z && z <= ymd_max)
+                {
+                // The range test above guarantees that z fits in an int.
+                z = YmdToJdn(ymd_t(static_cast<int>(z))).value();
+                values[j] = value_cast<std::string>(z);
+                }
+            else
+                {
+                alarum()
+                    << "Invalid date " << values[j]
+                    << " for '" << headers_[j] << "'"
+                    << " on line " << line_number << "."
+                    << LMI_FLUSH
+                    ;
+                }
+            }
+        try
+            {
+            cell[headers_[j]] = values[j];
+            }
+        catch(std::exception const& e)
+            {
+            alarum()
+                << "Line #" << line_number << ", "
+                << "column '" << headers_[j] << "': "
+                << e.what()
+                << LMI_FLUSH
+                ;
+            }
+        }
+}
+
+/// Split one line of delimited text into fields.
+///
+/// As with std::getline(), a terminal delimiter ends the last field
+/// rather than beginning an empty one, and an empty line has no
+/// fields. Tab-delimited text, as a spreadsheet copies it, is taken
+/// verbatim. With any other delimiter, as in CSV files, a field may
+/// be enclosed in double quotes, so that it can contain delimiters;
+/// within it, a pair of double quotes represents one.
+
+std::vector<std::string> split_census_record
+    (std::string const& record
+    ,char               delimiter
+    )
+{
+    bool const quotable = '\t' != delimiter;
+    std::vector<std::string> z;
+    std::string::size_type i = 0;
+    while(i < record.size())
+        {
+        std::string field;
+        if(quotable && '"' == record[i])
+            {
+            for(++i;; ++i)
+                {
+                if(record.size() <= i)
+                    {
+                    alarum()
+                        << "Unterminated quotation in census record '"
+                        << record
+                        << "'."
+                        << LMI_FLUSH
+                        ;
+                    }
+                if('"' == record[i])
+                    {
+                    if(i + 1 < record.size() && '"' == record[i + 1])
+                        {
+                        ++i;
+                        }
+                    else
+                        {
+                        ++i;
+                        break;
+                        }
+                    }
+                field += record[i];
+                }
+            if(i < record.size() && delimiter != record[i])
+                {
+                alarum()
+                    << "Quoted field not followed by delimiter in census record '"
+                    << record
+                    << "'."
+                    << LMI_FLUSH
+                    ;
+                }
+            }
+        else
+            {
+            std::string::size_type const end = std::min
+                (record.find(delimiter, i)
+                ,record.size()
+                );
+            field = record.substr(i, end - i);
+            i = end;
+            }
+        z.push_back(field);
+        ++i; // Skip the delimiter, if any.
+        }
+    return z;
+}
@@ -0,0 +1,86 @@
+// Import a census from delimited text.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef census_import_hpp
+#define census_import_hpp
+
+#include "config.hpp"
+
+#include "input.hpp"
+#include "so_attributes.hpp"
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// Import a census from delimited text.
+///
+/// The first line names members of class Input; each subsequent line
+/// holds the values of one cell, which is a copy of the exemplar with
+/// those members changed. Values are validated as they're assigned,
+/// so an invalid enumerative value or an out-of-range number is an
+/// error that identifies its line and column. Dates may be given
+/// either as JDN or as YYYYMMDD.
+///
+/// The exemplar is the case default, adjusted so that 'UseDOB' agrees
+/// with whichever of 'DateOfBirth' and 'IssueAge' is given.
+///
+/// Lines are read in batches. Each batch is parsed and reconciled on
+/// the given number of threads; then its cells are passed to the
+/// sink, in order, on the calling thread. Thus, only one batch
+/// of complete cells is held in memory at a time.
+
+class LMI_SO census_importer final
+{
+  public:
+    typedef std::function<void(Input const&)> cell_sink;
+
+    census_importer
+        (std::istream&       is
+        ,Input        const& case_default
+        ,char                delimiter
+        );
+
+    Input const& exemplar() const;
+
+    int import_cells(cell_sink const&, int number_of_threads);
+
+  private:
+    census_importer(census_importer const&) = delete;
+    census_importer& operator=(census_importer const&) = delete;
+
+    void parse_row(Input& cell, int line_number, std::string const&) const;
+
+    std::istream&            is_;
+    char              const  delimiter_;
+    Input                    exemplar_;
+    std::vector<std::string> headers_;
+    // Whether each column is a date.
+    std::vector<bool>        is_date_;
+};
+
+std::vector<std::string> LMI_SO split_census_record
+    (std::string const& record
+    ,char               delimiter
+    );
+
+#endif // census_import_hpp
@@ -0,0 +1,294 @@
+// Harmonize and validate census cells concurrently.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "census_validation.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "delta_census.hpp"
+#include "fenv_lmi.hpp"
+#include "input.hpp"
+
+#include <algorithm>                    // std::max(), std::min()
+#include <atomic>
+#include <cstddef>                      // std::size_t
+#include <exception>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+/// Harmonize one cell, and return a description of any problems.
+
+std::string harmonize_cell(Input& cell)
+{
+    try
+        {
+        cell.Reconcile();
+        std::string z;
+        for(auto const& i : cell.RealizeAllSequenceInput(false))
+            {
+            if(!i.empty())
+                {
+                z += (z.empty() ? "" : "\n") + i;
+                }
+            }
+        return z;
+        }
+    catch(std::exception const& e)
+        {
+        return e.what();
+        }
+    catch(...)
+        {
+        return "Unknown exception.";
+        }
+}
+
+/// Describing every problem in a large census would make a message
+/// too long to read; the first few suffice to show what's wrong.
+
+int const maximum_cells_described = 20;
+
+/// Call diagnose(j) for each cell index j, concurrently, and gather
+/// the nonempty results in cell order.
+///
+/// The first cell is diagnosed on the calling thread before any
+/// other thread is started, so that any lazily-initialized global
+/// state--e.g., product files cached on first use--is initialized
+/// without contention.
+
+std::vector<cell_diagnostics> diagnose_concurrently
+    (std::size_t                                   number_of_cells
+    ,int                                           number_of_threads
+    ,std::function<std::string(std::size_t)> const& diagnose
+    )
+{
+    LMI_ASSERT(0 < number_of_threads);
+    std::vector<std::string> messages(number_of_cells);
+    if(0 != number_of_cells)
+        {
+        messages[0] = diagnose(0);
+        }
+
+    std::atomic<std::size_t> next_cell(1);
+    auto work = [&] (int thread_number)
+        {
+        // Initialize each new thread's floating-point environment
+        // as the main thread's was initialized.
+        if(0 != thread_number)
+            {
+            fenv_initialize();
+            }
+        for(std::size_t j = next_cell++; j < number_of_cells; j = next_cell++)
+            {
+            messages[j] = diagnose(j);
+            }
+        };
+
+    std::size_t const n = std::min
+        (static_cast<std::size_t>(number_of_threads)
+        ,number_of_cells
+        );
+    std::vector<std::thread> threads;
+    for(std::size_t j = 1; j < n; ++j)
+        {
+        threads.emplace_back(work, static_cast<int>(j));
+        }
+    work(0);
+    for(auto& t : threads)
+        {
+        t.join();
+        }
+
+    std::vector<cell_diagnostics> z;
+    for(std::size_t j = 0; j < number_of_cells; ++j)
+        {
+        if(!messages[j].empty())
+            {
+            z.push_back({static_cast<int>(j), messages[j]});
+            }
+        }
+    return z;
+}
+
+/// Describe problems found in a census, naming each cell by calling
+/// insured_name(j) for its index j.
+
+std::string describe_diagnostics
+    (std::vector<cell_diagnostics>   const& diagnostics
+    ,std::size_t                            number_of_cells
+    ,std::function<std::string(int)> const& insured_name
+    )
+{
+    std::ostringstream oss;
+    oss
+        << "Input validation problems in "
+        << diagnostics.size()
+        << " of "
+        << number_of_cells
+        << " cells:"
+        ;
+    int n = 0;
+    for(auto const& i : diagnostics)
+        {
+        if(maximum_cells_described == n++)
+            {
+            oss << "\n...and " << diagnostics.size() - maximum_cells_described << " more.";
+            break;
+            }
+        oss
+            << "\nCell number "
+            << 1 + i.index
+            << " ('"
+            << insured_name(i.index)
+            << "'):\n"
+            << i.message
+            ;
+        }
+    return oss.str();
+}
+} // Unnamed namespace.
+
+/// Harmonize all cells in place, and gather any problems found.
+///
+/// Each cell is reconciled, which makes its values consistent just
+/// as editing it would, and then its sequences are realized, which
+/// validates them. Diagnostics are returned in cell order, however
+/// many threads are used. An invalid cell is left as reconciliation
+/// left it.
+
+std::vector<cell_diagnostics> harmonize_census_cells
+    (std::vector<Input>& cells
+    ,int                 number_of_threads
+    )
+{
+    return diagnose_concurrently
+        (cells.size()
+        ,number_of_threads
+        ,[&cells] (std::size_t j) {return harmonize_cell(cells[j]);}
+        );
+}
+
+/// Gather any problems that harmonizing the cells would find, but
+/// leave the cells unchanged.
+
+std::vector<cell_diagnostics> diagnose_census_cells
+    (std::vector<Input> const& cells
+    ,int                       number_of_threads
+    )
+{
+    return diagnose_concurrently
+        (cells.size()
+        ,number_of_threads
+        ,[&cells] (std::size_t j) {Input z(cells[j]); return harmonize_cell(z);}
+        );
+}
+
+/// Gather any problems that harmonizing the cells of a sparsely-
+/// stored census would find. Each cell is materialized only while
+/// it is being diagnosed.
+
+std::vector<cell_diagnostics> diagnose_census_cells
+    (delta_census const& cells
+    ,int                 number_of_threads
+    )
+{
+    return diagnose_concurrently
+        (static_cast<std::size_t>(cells.size())
+        ,number_of_threads
+        ,[&cells] (std::size_t j)
+            {
+            Input z(cells[static_cast<int>(j)].materialize());
+            return harmonize_cell(z);
+            }
+        );
+}
+
+/// Describe problems found by harmonize_census_cells().
+///
+/// Cells are numbered from one, as in the census view.
+
+std::string describe_census_diagnostics
+    (std::vector<cell_diagnostics> const& diagnostics
+    ,std::vector<Input>            const& cells
+    )
+{
+    return describe_diagnostics
+        (diagnostics
+        ,cells.size()
+        ,[&cells] (int j) {return cells[j]["InsuredName"].str();}
+        );
+}
+
+std::string describe_census_diagnostics
+    (std::vector<cell_diagnostics> const& diagnostics
+    ,delta_census                  const& cells
+    )
+{
+    return describe_diagnostics
+        (diagnostics
+        ,static_cast<std::size_t>(cells.size())
+        ,[&cells] (int j) {return cells[j]["InsuredName"];}
+        );
+}
+
+/// Throw, describing every invalid cell, if any cell is invalid.
+
+void validate_census
+    (std::vector<Input> const& cells
+    ,int                       number_of_threads
+    )
+{
+    std::vector<cell_diagnostics> const z = diagnose_census_cells
+        (cells
+        ,number_of_threads
+        );
+    if(!z.empty())
+        {
+        alarum() << describe_census_diagnostics(z, cells) << LMI_FLUSH;
+        }
+}
+
+void validate_census
+    (delta_census const& cells
+    ,int                 number_of_threads
+    )
+{
+    std::vector<cell_diagnostics> const z = diagnose_census_cells
+        (cells
+        ,number_of_threads
+        );
+    if(!z.empty())
+        {
+        alarum() << describe_census_diagnostics(z, cells) << LMI_FLUSH;
+        }
+}
+
+/// Number of threads to use for work on all cells of a census.
+
+int default_number_of_threads()
+{
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
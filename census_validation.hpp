@@ -0,0 +1,80 @@
+// Harmonize and validate census cells concurrently.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef census_validation_hpp
+#define census_validation_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <string>
+#include <vector>
+
+class Input;
+class delta_census;
+
+/// Problems found in one cell, identified by its zero-origin index.
+
+struct cell_diagnostics
+{
+    int         index;
+    std::string message;
+};
+
+std::vector<cell_diagnostics> LMI_SO harmonize_census_cells
+    (std::vector<Input>& cells
+    ,int                 number_of_threads
+    );
+
+std::vector<cell_diagnostics> LMI_SO diagnose_census_cells
+    (std::vector<Input> const& cells
+    ,int                       number_of_threads
+    );
+
+std::vector<cell_diagnostics> LMI_SO diagnose_census_cells
+    (delta_census const& cells
+    ,int                 number_of_threads
+    );
+
+std::string LMI_SO describe_census_diagnostics
+    (std::vector<cell_diagnostics> const& diagnostics
+    ,std::vector<Input>            const& cells
+    );
+
+std::string LMI_SO describe_census_diagnostics
+    (std::vector<cell_diagnostics> const& diagnostics
+    ,delta_census                  const& cells
+    );
+
+void LMI_SO validate_census
+    (std::vector<Input> const& cells
+    ,int                       number_of_threads
+    );
+
+void LMI_SO validate_census
+    (delta_census const& cells
+    ,int                 number_of_threads
+    );
+
+int LMI_SO default_number_of_threads();
+
+#endif // census_validation_hpp
@@ -26,10 +26,10 @@
 #include "alert.hpp"
 #include "assert_lmi.hpp"
 #include "census_document.hpp"
-#include "contains.hpp"
+#include "census_import.hpp"
+#include "census_validation.hpp"
 #include "default_view.hpp"
 #include "edit_mvc_docview_parameters.hpp"
-#include "facets.hpp"                   // tab_is_not_whitespace_locale()
 #include "illustration_view.hpp"
 #include "illustrator.hpp"
 #include "input.hpp"
@@ -60,7 +60,6 @@
 #include <algorithm>
 #include <cctype>
 #include <cstddef>                      // std::size_t
-#include <istream>                      // std::ws
 #include <iterator>                     // std::insert_iterator
 #include <sstream>
 
@@ -1000,6 +999,16 @@ wxWindow* CensusView::CreateChildWindow()
 
     list_window_->Select(list_model_->GetItem(0));
 
+    // Report any invalid cells now, rather than when they're run.
+    std::vector<cell_diagnostics> const z = diagnose_census_cells
+        (cell_parms()
+        ,default_number_of_threads()
+        );
+    if(!z.empty())
+        {
+        warning() << describe_census_diagnostics(z, cell_parms()) << LMI_FLUSH;
+        }
+
     status() << std::flush;
 
     return list_window_;
@@ -1158,16 +1167,17 @@ void CensusView::apply_changes
             }
         }
 
-    // Probably this should be factored out into a member function
-    // that's called elsewhere too--e.g., when a cell is read from
-    // file, or when a census is pasted.
     for(auto& j : class_parms())
         {
         j.Reconcile();
         }
-    for(auto& j : cell_parms())
+    std::vector<cell_diagnostics> const z = harmonize_census_cells
+        (cell_parms()
+        ,default_number_of_threads()
+        );
+    if(!z.empty())
         {
-        j.Reconcile();
+        warning() << describe_census_diagnostics(z, cell_parms()) << LMI_FLUSH;
         }
 }
 
@@ -1610,154 +1620,32 @@ void CensusView::UponRunCaseToGroupRoster(wxCommandEvent&)
 void CensusView::UponPasteCensus(wxCommandEvent&)
 {
     std::string const census_data = ClipboardEx::GetText();
-
-    std::vector<std::string> headers;
-    std::vector<Input> cells;
-
-    std::istringstream iss_census(census_data);
-    iss_census.imbue(tab_is_not_whitespace_locale());
-    std::string line;
-
-    // Get header line; parse into field names.
-    if(std::getline(iss_census, line, '\n'))
-        {
-        iss_census >> std::ws;
-
-        std::istringstream iss_line(line);
-        std::string token;
-
-        while(std::getline(iss_line, token, '\t'))
-            {
-            headers.push_back(token);
-            }
-        }
-    else
+    if(census_data.empty())
         {
         warning() << "Error pasting census data: no header line." << LMI_FLUSH;
         return;
         }
 
-    // Use a modifiable copy of case defaults as an exemplar for new
-    // cells to be created by pasting. Modifications are conditionally
-    // written back to case defaults later.
-    Input exemplar(case_parms()[0]);
-
-    // Force 'UseDOB' prn. Pasting it as a column never makes sense.
-    if(contains(headers, "UseDOB"))
-        {
-        warning() << "'UseDOB' is unnecessary and will be ignored." << std::flush;
-        }
-    bool const dob_pasted = contains(headers, "DateOfBirth");
-    bool const age_pasted = contains(headers, "IssueAge");
-    if(dob_pasted && age_pasted)
-        {
-        alarum()
-            << "Cannot paste both 'DateOfBirth' and 'IssueAge'."
-            << LMI_FLUSH
-            ;
-        }
-    else if(dob_pasted)
-        {
-        exemplar["UseDOB"] = "Yes";
-        }
-    else if(age_pasted)
-        {
-        exemplar["UseDOB"] = "No";
-        }
-    else
-        {
-        ; // Do nothing: neither age nor DOB pasted.
-        }
-
-    // Read each subsequent line into an input object representing one cell.
-    int current_line = 0;
-    while(std::getline(iss_census, line, '\n'))
-        {
-        ++current_line;
-
-        iss_census >> std::ws;
-
-        Input current_cell(exemplar);
+    std::istringstream iss_census(census_data);
+    census_importer importer(iss_census, case_parms()[0], '\t');
 
-        std::istringstream iss_line(line);
-        std::string token;
-        std::vector<std::string> values;
+    // New cells are created by pasting onto a copy of case defaults,
+    // modified to suit the pasted columns. Modifications are
+    // conditionally written back to case defaults later.
+    Input const& exemplar = importer.exemplar();
 
-        while(std::getline(iss_line, token, '\t'))
-            {
-#if 0 // expunge soon?
-            static std::string const space(" ");
-            if(std::string::npos == token.find_first_not_of(space))
-                {
-                warning()
-                    << "Line #" << current_line << ": "
-                    << " (" << line << ") "
-                    << "has a value that contains no non-blank characters. "
-                    << "Last valid value, if any: " << values.back()
-                    << LMI_FLUSH
-                    ;
-// TODO ?? It would be better to use alarum() instead of
-// warning() followed by alarum() with a short string, but
-// apparently that can segfault with very long strings. Is there
-// a limit on exception size that should be tested here? See:
-//   http://savannah.nongnu.org/bugs/?20240
-                alarum() << "Invalid input." << LMI_FLUSH;
-                }
-#endif // 0
-            values.push_back(token);
-            }
-
-        if(values.size() != headers.size())
-            {
-            alarum()
-                << "Line #" << current_line << ": "
-                << "  (" << line << ") "
-                << "should have one value per column. "
-                << "Number of values: " << values.size() << "; "
-                << "number expected: " << headers.size() << "."
-                << LMI_FLUSH
-                ;
-            }
-
-        for(unsigned int j = 0; j < headers.size(); ++j)
+    std::vector<Input> cells;
+    importer.import_cells
+        ([&cells] (Input const& cell)
             {
-            if(exact_cast<tnr_date>(current_cell[headers[j]]))
-                {
-                static long int const jdn_min = calendar_date::gregorian_epoch_jdn;
-                static long int const jdn_max = calendar_date::last_yyyy_date_jdn;
-                static long int const ymd_min = JdnToYmd(jdn_t(jdn_min)).value();
-                static long int const ymd_max = JdnToYmd(jdn_t(jdn_max)).value();
-                long int z = value_cast<long int>(values[j]);
-                if(jdn_min <= z && z <= jdn_max)
-                    {
-                    ; // Do nothing: JDN is the default expectation.
-                    }
-                else if(ymd_min <= z && z <= ymd_max)
-                    {
-                    z = YmdToJdn(ymd_t(z)).value();
-                    values[j] = value_cast<std::string>(z);
-                    }
-                else
-                    {
-                    alarum()
-                        << "Invalid date " << values[j]
-                        << " for '" << headers[j] << "'"
-                        << " on line " << current_line << "."
-                        << LMI_FLUSH
-                        ;
-                    }
-                }
-            current_cell[headers[j]] = values[j];
+            cells.push_back(cell);
+            status() << "Added cell number " << cells.size() << '.' << std::flush;
+            wxSafeYield();
             }
-        current_cell.Reconcile();
-        current_cell.RealizeAllSequenceInput();
-        cells.push_back(current_cell);
-
-        status() << "Added cell number " << cells.size() << '.' << std::flush;
-        wxSafeYield();
-        }
+        ,default_number_of_threads()
+        );
 
-    if(0 == current_line)
+    if(cells.empty())
         {
         warning() << "No cells to paste." << LMI_FLUSH;
         return;
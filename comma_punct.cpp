@@ -0,0 +1,107 @@
+// Punctuate numbers with commas.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "comma_punct.hpp"
+
+#include "alert.hpp"
+
+#include <cstdio>                       // std::snprintf()
+#include <cstring>                      // std::memmove()
+
+/// Format a number in fixed notation with comma thousands separators.
+///
+/// Write a null-terminated string into 'buffer', and return its
+/// length. The result is the same as inserting 'd' into a std::ostream
+/// imbued with comma_punct, with std::ios_base::fixed and precision
+/// 'decimals', but is obtained much faster: no stream or locale is
+/// created, and the only conversion is the std::snprintf() that the
+/// stream would perform anyway.
+///
+/// Separators are inserted in place, working from right to left, into
+/// the run of digits that follows any sign. Non-finite values have no
+/// such digits, so they're written exactly as std::snprintf() writes
+/// them.
+
+std::size_t format_with_commas
+    (char*       buffer
+    ,std::size_t buffer_size
+    ,double      d
+    ,int         decimals
+    )
+{
+    if(decimals < 0 || max_comma_format_decimals < decimals)
+        {
+        alarum() << "Invalid number of decimals " << decimals << "." << LMI_FLUSH;
+        }
+
+    int const n = std::snprintf(buffer, buffer_size, "%.*f", decimals, d);
+    if(n < 0 || buffer_size <= static_cast<std::size_t>(n))
+        {
+        alarum() << "Formatting error." << LMI_FLUSH;
+        }
+    std::size_t length = static_cast<std::size_t>(n);
+
+    std::size_t const first = ('-' == buffer[0] || '+' == buffer[0]) ? 1 : 0;
+    std::size_t last = first;
+    while(last < length && '0' <= buffer[last] && buffer[last] <= '9')
+        {
+        ++last;
+        }
+    std::size_t const digits = last - first;
+    std::size_t const separators = (0 == digits) ? 0 : (digits - 1) / 3;
+    if(0 == separators)
+        {
+        return length;
+        }
+    if(buffer_size <= length + separators)
+        {
+        alarum() << "Formatting error." << LMI_FLUSH;
+        }
+
+    // Move the part after the integral digits, including the
+    // terminating null, then copy digits backward, separating
+    // each group of three.
+    std::memmove(buffer + last + separators, buffer + last, 1 + length - last);
+    char* src = buffer + last;
+    char* dst = src + separators;
+    for(std::size_t j = 0; j < digits; ++j)
+        {
+        if(0 != j && 0 == j % 3)
+            {
+            *--dst = ',';
+            }
+        *--dst = *--src;
+        }
+    return length + separators;
+}
+
+/// Format a number in fixed notation with comma thousands separators.
+///
+/// This convenience overload returns a std::string.
+
+std::string format_with_commas(double d, int decimals)
+{
+    char buffer[comma_format_buffer_size];
+    std::size_t const n = format_with_commas(buffer, sizeof buffer, d, decimals);
+    return std::string(buffer, n);
+}
@@ -24,6 +24,9 @@
 
 #include "config.hpp"
 
+#include "so_attributes.hpp"
+
+#include <cstddef>                      // std::size_t
 #include <locale>
 #include <string>
 
@@ -49,5 +52,26 @@ class comma_punct
     std::string do_grouping() const override {return "\003";}
 };
 
+/// Largest number of decimals format_with_commas() accepts.
+
+int const max_comma_format_decimals = 32;
+
+/// Buffer size sufficient for format_with_commas() with any double.
+///
+/// The largest finite double has 309 integral digits, which take 102
+/// separators; add sign, decimal point, decimals, and terminating null.
+
+std::size_t const comma_format_buffer_size =
+    309 + 102 + 1 + 1 + max_comma_format_decimals + 1;
+
+std::size_t LMI_SO format_with_commas
+    (char*       buffer
+    ,std::size_t buffer_size
+    ,double      d
+    ,int         decimals
+    );
+
+std::string LMI_SO format_with_commas(double d, int decimals);
+
 #endif // comma_punct_hpp
 
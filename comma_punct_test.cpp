@@ -23,13 +23,105 @@
 
 #include "comma_punct.hpp"
 
+#include "ieee754.hpp"                  // infinity<>()
+#include "miscellany.hpp"               // lmi_array_size(), stifle_warning_for_unused_value()
 #include "test_tools.hpp"
+#include "timer.hpp"
 
+#include <cmath>                        // std::ldexp()
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
+#include <string>
 
-// TODO ?? More tests should be added.
+namespace
+{
+/// Format a number as the ledger formerly did, using a stream.
+
+std::string stream_format(double d, int decimals)
+{
+    std::ostringstream oss;
+    std::locale loc;
+    std::locale new_loc(loc, new comma_punct);
+    oss.imbue(new_loc);
+    oss.setf(std::ios_base::fixed, std::ios_base::floatfield);
+    oss.precision(decimals);
+    oss << d;
+    return oss.str();
+}
+
+void test_equivalence(double d, int decimals, char const* file, int line)
+{
+    INVOKE_BOOST_TEST_EQUAL
+        (stream_format(d, decimals)
+        ,format_with_commas(d, decimals)
+        ,file
+        ,line
+        );
+}
+
+#define TEST_EQUIVALENCE(d, decimals) \
+    test_equivalence(d, decimals, __FILE__, __LINE__)
+
+double const sample_values[] =
+    {0.0
+    ,-0.0
+    ,0.005
+    ,0.015
+    ,-0.5
+    ,1.0
+    ,-12.345
+    ,999.995
+    ,-999.995
+    ,1000.0
+    ,-1234.5
+    ,99999.999
+    ,123456.789
+    ,-1234567.0
+    ,1.0e15
+    ,-9007199254740993.0
+    ,1.0e20
+    ,1.0e100
+    ,2.0 / 3.0
+    ,std::numeric_limits<double>::max()
+    ,-std::numeric_limits<double>::max()
+    ,std::numeric_limits<double>::min()
+    ,std::numeric_limits<double>::denorm_min()
+    };
+
+/// Values typical of ledger columns, for timing.
+
+double const typical_values[] =
+    {0.0
+    ,12.34
+    ,100.0
+    ,1234.5
+    ,-56789.01
+    ,250000.0
+    ,1234567.89
+    ,0.0425
+    };
+
+void mete_stream()
+{
+    for(auto const& i : typical_values)
+        {
+        std::string s = stream_format(i, 2);
+        stifle_warning_for_unused_value(s);
+        }
+}
+
+void mete_buffer()
+{
+    char buffer[comma_format_buffer_size];
+    for(auto const& i : typical_values)
+        {
+        std::size_t n = format_with_commas(buffer, sizeof buffer, i, 2);
+        stifle_warning_for_unused_value(n);
+        }
+}
+} // Unnamed namespace.
 
 int test_main(int, char*[])
 {
@@ -43,6 +135,59 @@ int test_main(int, char*[])
     oss << std::setprecision(2) << -999;
     BOOST_TEST_EQUAL("-999", oss.str());
 
+    // format_with_commas() must produce the same text as a stream.
+
+    for(auto const& i : sample_values)
+        {
+        for(int j = 0; j <= 6; ++j)
+            {
+            TEST_EQUIVALENCE( i, j);
+            TEST_EQUIVALENCE(-i, j);
+            }
+        }
+
+    for(int j = -1074; j <= 1023; j += 7)
+        {
+        TEST_EQUIVALENCE( std::ldexp(1.0, j), 2);
+        TEST_EQUIVALENCE(-std::ldexp(1.0, j), 0);
+        }
+
+    TEST_EQUIVALENCE( infinity<double>(), 2);
+    TEST_EQUIVALENCE(-infinity<double>(), 0);
+    TEST_EQUIVALENCE(std::numeric_limits<double>::quiet_NaN(), 2);
+
+    TEST_EQUIVALENCE(1.0, max_comma_format_decimals);
+    TEST_EQUIVALENCE(-std::numeric_limits<double>::max(), max_comma_format_decimals);
+
+    BOOST_TEST_EQUAL("1,234,567.89", format_with_commas( 1234567.891, 2));
+    BOOST_TEST_EQUAL("-1,000"      , format_with_commas(   -999.5   , 0));
+    BOOST_TEST_EQUAL("100"         , format_with_commas(    100.0   , 0));
+
+    char small_buffer[8];
+    BOOST_TEST_EQUAL(7U, format_with_commas(small_buffer, sizeof small_buffer, 1234.5, 1));
+    BOOST_TEST_EQUAL(std::string("1,234.5"), small_buffer);
+    BOOST_TEST_THROW
+        (format_with_commas(small_buffer, sizeof small_buffer, 12345.5, 1)
+        ,std::runtime_error
+        ,"Formatting error."
+        );
+    BOOST_TEST_THROW
+        (format_with_commas(1.0, -1)
+        ,std::runtime_error
+        ,"Invalid number of decimals -1."
+        );
+    BOOST_TEST_THROW
+        (format_with_commas(1.0, 1 + max_comma_format_decimals)
+        ,std::runtime_error
+        ,"Invalid number of decimals 33."
+        );
+
+    std::cout
+        << "Format " << lmi_array_size(typical_values) << " values:"
+        << "\n  stream: " << TimeAnAliquot(mete_stream)
+        << "\n  buffer: " << TimeAnAliquot(mete_buffer)
+        << std::endl
+        ;
+
     return EXIT_SUCCESS;
 }
-
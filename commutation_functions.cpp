@@ -23,13 +23,17 @@
 
 #include "commutation_functions.hpp"
 
+#include "alert.hpp"
 #include "assert_lmi.hpp"
 #include "et_vector.hpp"                // [VECTORIZE]
 
-#include <algorithm>                    // std::rotate_copy() [VECTORIZE]
+#include <algorithm>                    // std::equal(), std::rotate_copy()
 #include <cmath>                        // std::pow()
-#include <functional>                   // std::multiplies()  [VECTORIZE]
+#include <cstddef>                      // std::size_t
+#include <functional>                   // std::hash, std::multiplies()
+#include <mutex>
 #include <numeric>                      // std::partial_sum()
+#include <unordered_map>
 
 /// Interest- and mortality-rate vectors --> commutation functions.
 ///
@@ -94,6 +98,118 @@ OLCommFns::OLCommFns
     std::partial_sum(c.rbegin(), c.rend(), m.rbegin());
 }
 
+namespace
+{
+/// Integral power of a number whose twelfth power is already known.
+///
+/// The exponent is a compile-time constant, so for the two modes used
+/// most often--monthly and annual--no further call to std::pow() is
+/// needed: x^1 is exactly x, and x^12 has already been calculated.
+/// Results are therefore identical to those of std::pow(x, n).
+
+template<int n>
+inline double modal_power(double x, double x12)
+{
+    static_assert(0 < n && n <= 12 && 0 == 12 % n, "");
+    return (1 == n) ? x : (12 == n) ? x12 : std::pow(x, n);
+}
+
+/// UL commutation functions for a mode known at compile time.
+///
+/// The first pass calculates each year's discount factors, which are
+/// mutually independent. The forward product of the per-period
+/// discount factors, which is inherently serial, is then a single
+/// std::partial_sum(); and the modal D and C follow elementwise. Each
+/// value is calculated by the same sequence of floating-point
+/// operations as in the single-loop implementation this replaces, so
+/// the results are identical.
+///
+/// Output vector 'ad' must have one more element than the input
+/// vectors; 'kd' and 'kc', the same number.
+
+template<int periods_per_year>
+void ul_comm_fns_kernel
+    (std::vector<double> const& qc
+    ,std::vector<double> const& ic
+    ,std::vector<double> const& ig
+    ,mcenum_dbopt_7702          dbo
+    ,std::vector<double>&       ad
+    ,std::vector<double>&       kd
+    ,std::vector<double>&       kc
+    )
+{
+    int const months_per_period = 12 / periods_per_year;
+    int const length = static_cast<int>(qc.size());
+
+    std::vector<double> vpn(length);
+    std::vector<double> ka (length);
+    std::vector<double> vv (length);
+    std::vector<double> qq (length);
+
+    for(int j = 0; j < length; j++)
+        {
+        LMI_ASSERT( 0.0 <= qc[j] && qc[j] <= 1.0);
+        LMI_ASSERT(-1.0 <  ic[j]);
+        LMI_ASSERT( 0.0 <= ig[j]);
+        // Eckley equations (7) and (8).
+        double f = qc[j] * (1.0 + ic[j]) / (1.0 + ig[j]);
+        // f cannot be negative, so division by 1+f is safe.
+        double g = 1.0 / (1.0 + f);
+        // Eckley equation (11).
+        double i = (ic[j] + ig[j] * f) * g;
+        // Eckley equation (12).
+        double q = f * g;
+        // Eckley equation (19).
+        if(mce_option2_for_7702 == dbo)
+            {
+            i = i - q;
+            }
+        LMI_ASSERT(-1.0 != i);
+        double v = 1.0 / (1.0 + i);
+        double p = 1.0 - q;
+        // Present value of $1 one month hence.
+        double vp = v * p;
+        // Present value of $1 twelve months hence.
+        double vp12 = std::pow(vp, 12);
+        vpn[j] = modal_power<periods_per_year>(vp, vp12);
+        // Twelve times a'' upper 12 (Eckley equations 28 and 31),
+        // determined analytically using the geometric series theorem.
+//      double aa = 1.0;
+//      // Eckley equation (31).
+//      double sa = (1.0 - vp12) / (1.0 - std::pow(vp, 6));
+//      double qa = (1.0 - vp12) / (1.0 - std::pow(vp, 3));
+//      // Eckley equation (28).
+//      double ma = (1.0 - vp12) / (1.0 - vp);
+        // The prefix k indicates the processing mode, which is
+        // an input parameter.
+        ka[j] = 1.0;
+        if(1.0 != vp)
+            {
+            ka[j] =
+                  (1.0 - vp12)
+                / (1.0 - modal_power<months_per_period>(vp, vp12))
+                ;
+            }
+        vv[j] = v;
+        qq[j] = q;
+        }
+
+    ad[0] = 1.0;
+    std::partial_sum
+        (vpn.begin()
+        ,vpn.end()
+        ,1 + ad.begin()
+        ,std::multiplies<double>()
+        );
+
+    for(int j = 0; j < length; j++)
+        {
+        kd[j] = ka[j] * ad[j];
+        kc[j] = ka[j] * ad[j] * vv[j] * qq[j];
+        }
+}
+} // Unnamed namespace.
+
 /// Interest- and mortality-rate vectors --> commutation functions.
 ///
 /// Constructor arguments:
@@ -111,7 +227,9 @@ OLCommFns::OLCommFns
 /// class's responsibility to choose.
 ///
 /// The mode argument specifies the frequency of UL n-iversary
-/// processing. This is most often monthly, but need not be.
+/// processing. This is most often monthly, but need not be. Each
+/// mode is dispatched to a specialization of ul_comm_fns_kernel(),
+/// so that no mode-dependent logic remains in the inner loop.
 
 ULCommFns::ULCommFns
     (std::vector<double> const& a_qc
@@ -136,54 +254,32 @@ ULCommFns::ULCommFns
     an.resize(    Length);
     km.resize(    Length);
 
-    int periods_per_year = mode_;
-    int months_per_period = 12 / periods_per_year;
-
-    ad[0] = 1.0;
-    for(int j = 0; j < Length; j++)
+    switch(mode_)
         {
-        LMI_ASSERT( 0.0 <= qc[j] && qc[j] <= 1.0);
-        LMI_ASSERT(-1.0 <  ic[j]);
-        LMI_ASSERT( 0.0 <= ig[j]);
-        // Eckley equations (7) and (8).
-        double f = qc[j] * (1.0 + ic[j]) / (1.0 + ig[j]);
-        // f cannot be negative, so division by 1+f is safe.
-        double g = 1.0 / (1.0 + f);
-        // Eckley equation (11).
-        double i = (ic[j] + ig[j] * f) * g;
-        // Eckley equation (12).
-        double q = f * g;
-        // Eckley equation (19).
-        if(mce_option2_for_7702 == dbo_)
+        case mce_annual:
             {
-            i = i - q;
+            ul_comm_fns_kernel< 1>(qc, ic, ig, dbo_, ad, kd, kc);
             }
-        LMI_ASSERT(-1.0 != i);
-        double v = 1.0 / (1.0 + i);
-        double p = 1.0 - q;
-        // Present value of $1 one month hence.
-        double vp = v * p;
-        // Present value of $1 twelve months hence.
-        double vp12 = std::pow(vp, 12);
-        double vpn  = std::pow(vp, periods_per_year);
-        // Twelve times a'' upper 12 (Eckley equations 28 and 31),
-        // determined analytically using the geometric series theorem.
-//      double aa = 1.0;
-//      // Eckley equation (31).
-//      double sa = (1.0 - vp12) / (1.0 - std::pow(vp, 6));
-//      double qa = (1.0 - vp12) / (1.0 - std::pow(vp, 3));
-//      // Eckley equation (28).
-//      double ma = (1.0 - vp12) / (1.0 - vp);
-        // The prefix k indicates the processing mode, which is
-        // an input parameter.
-        double ka = 1.0;
-        if(1.0 != vp)
+            break;
+        case mce_semiannual:
+            {
+            ul_comm_fns_kernel< 2>(qc, ic, ig, dbo_, ad, kd, kc);
+            }
+            break;
+        case mce_quarterly:
+            {
+            ul_comm_fns_kernel< 4>(qc, ic, ig, dbo_, ad, kd, kc);
+            }
+            break;
+        case mce_monthly:
             {
-            ka = (1.0 - vp12) / (1.0 - std::pow(vp, months_per_period));
+            ul_comm_fns_kernel<12>(qc, ic, ig, dbo_, ad, kd, kc);
+            }
+            break;
+        default:
+            {
+            alarum() << "Case '" << mode_ << "' not found." << LMI_FLUSH;
             }
-        kd[j] = ka * ad[j];
-        kc[j] = ka * ad[j] * v * q;
-        ad[1 + j] = ad[j] * vpn;
         }
 
     ead = ad;
@@ -194,3 +290,131 @@ ULCommFns::ULCommFns
     std::partial_sum(kc.rbegin(), kc.rend(), km.rbegin());
 }
 
+namespace
+{
+void hash_combine(std::size_t& seed, std::size_t h)
+{
+    seed ^= h + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+std::size_t hash_vector(std::size_t seed, std::vector<double> const& v)
+{
+    hash_combine(seed, v.size());
+    std::hash<double> const hasher {};
+    for(auto const& i : v)
+        {
+        hash_combine(seed, hasher(i));
+        }
+    return seed;
+}
+
+/// Use std::equal() because PETE hijacks operator==() for vectors.
+
+bool same_values(std::vector<double> const& a, std::vector<double> const& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+struct ul_comm_fns_entry
+{
+    std::vector<double>              qc;
+    std::vector<double>              ic;
+    std::vector<double>              ig;
+    mcenum_dbopt_7702                dbo;
+    mcenum_mode                      mode;
+    std::shared_ptr<ULCommFns const> value;
+};
+} // Unnamed namespace.
+
+/// UL commutation functions, shared among all clients that request
+/// them for identical arguments.
+///
+/// Motivation: 7702 and 7702A calculations need the same commutation
+/// functions for every cell whose 7702 mortality and interest rates
+/// and death benefit option are the same--typically, all cells of
+/// the same rate class and issue age. This flyweight lets them share
+/// one instance, which is never modified after construction.
+///
+/// Lookup must be cheap, because it's done for every cell. Copying
+/// the arguments into a key for each lookup would cost nearly as much
+/// as a cache hit saves, so entries are found by a hash of the
+/// arguments, and only a hash match is compared element by element
+/// with the arguments retained in the entry. Hashing and comparing
+/// cost far less than calculating the functions, which requires two
+/// calls to std::pow() for each element.
+///
+/// The cache is simply cleared when it grows large, so that it can't
+/// grow without bound if many cells are substandard: a census rarely
+/// has more than a few hundred distinct keys, and the cost of clearing
+/// it occasionally is negligible. As with class file_cache (q.v.),
+/// the cache is a function-local static, and access to it is
+/// serialized by a mutex, so that cells can be run concurrently.
+
+std::shared_ptr<ULCommFns const> shared_ul_comm_fns
+    (std::vector<double> const& a_qc
+    ,std::vector<double> const& a_ic
+    ,std::vector<double> const& a_ig
+    ,mcenum_dbopt_7702          dbo
+    ,mcenum_mode                mode
+    )
+{
+    using cache_type = std::unordered_multimap<std::size_t,ul_comm_fns_entry>;
+    static cache_type cache;
+    static std::mutex cache_mutex;
+    static cache_type::size_type const max_size = 1000;
+
+    std::size_t key = 0;
+    hash_combine(key, static_cast<std::size_t>(dbo));
+    hash_combine(key, static_cast<std::size_t>(mode));
+    key = hash_vector(key, a_qc);
+    key = hash_vector(key, a_ic);
+    key = hash_vector(key, a_ig);
+
+    // Call only while holding the lock.
+    auto const find = [&] () -> std::shared_ptr<ULCommFns const>
+        {
+        auto const range = cache.equal_range(key);
+        for(auto i = range.first; i != range.second; ++i)
+            {
+            ul_comm_fns_entry const& e = i->second;
+            if
+                (   dbo  == e.dbo
+                &&  mode == e.mode
+                &&  same_values(a_qc, e.qc)
+                &&  same_values(a_ic, e.ic)
+                &&  same_values(a_ig, e.ig)
+                )
+                {
+                return e.value;
+                }
+            }
+        return nullptr;
+        };
+
+    {
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if(auto const z = find())
+        {
+        return z;
+        }
+    }
+
+    // Construct outside the lock, because construction is costly, and
+    // before inserting, because the ctor might throw. Another thread
+    // may meanwhile have inserted an equivalent instance; if so, share
+    // that one instead.
+    std::shared_ptr<ULCommFns const> const value
+        (new ULCommFns(a_qc, a_ic, a_ig, dbo, mode)
+        );
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    if(auto const z = find())
+        {
+        return z;
+        }
+    if(max_size <= cache.size())
+        {
+        cache.clear();
+        }
+    cache.emplace(key, ul_comm_fns_entry {a_qc, a_ic, a_ig, dbo, mode, value});
+    return value;
+}
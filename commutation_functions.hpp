@@ -27,6 +27,7 @@
 #include "mc_enum_type_enums.hpp"
 #include "so_attributes.hpp"
 
+#include <memory>                       // std::shared_ptr
 #include <vector>
 
 /// Ordinary-life commutation functions.
@@ -122,5 +123,13 @@ class LMI_SO ULCommFns final
     std::vector<double>  km;
 };
 
+std::shared_ptr<ULCommFns const> LMI_SO shared_ul_comm_fns
+    (std::vector<double> const& a_qc
+    ,std::vector<double> const& a_ic
+    ,std::vector<double> const& a_ig
+    ,mcenum_dbopt_7702          dbo
+    ,mcenum_mode                mode
+    );
+
 #endif // commutation_functions_hpp
 
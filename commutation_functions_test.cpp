@@ -34,6 +34,7 @@
 #include <functional>                   // std::bind()
 #include <iomanip>                      // std::setw() etc.
 #include <ios>                          // std::ios_base::fixed()
+#include <memory>                       // std::shared_ptr
 #include <numeric>                      // std::partial_sum()
 #include <vector>
 
@@ -78,6 +79,15 @@ void mete_ulcf
     ULCommFns(q, ic, ig, mce_option1_for_7702, mce_monthly);
 }
 
+void mete_ulcf_shared
+    (std::vector<double> const& q
+    ,std::vector<double> const& ic
+    ,std::vector<double> const& ig
+    )
+{
+    shared_ul_comm_fns(q, ic, ig, mce_option1_for_7702, mce_monthly);
+}
+
 void mete_reserve
     (ULCommFns const&     ulcf
     ,std::vector<double>& reserve
@@ -706,6 +716,19 @@ void Test_1980_CSO_Male_ANB()
         << '\n'
         ;
 
+    std::cout
+        << "  Speed test: retrieve shared UL commutation functions\n    "
+        << TimeAnAliquot
+            (std::bind
+                (mete_ulcf_shared
+                ,q
+                ,ic
+                ,ig
+                )
+            )
+        << '\n'
+        ;
+
     std::cout
         << "  Speed test: calculate yearly account values\n    "
         << TimeAnAliquot
@@ -732,12 +755,173 @@ void TestLimits()
     BOOST_TEST_EQUAL(0.0, ulcf.kC().back());
 }
 
+/// UL commutation functions, calculated by the straightforward single
+/// loop that ULCommFns formerly used, with mode as a runtime variable
+/// and three calls to std::pow() for each element.
+
+struct ul_reference
+{
+    ul_reference
+        (std::vector<double> const& qc
+        ,std::vector<double> const& ic
+        ,std::vector<double> const& ig
+        ,mcenum_dbopt_7702          dbo
+        ,mcenum_mode                mode
+        )
+        {
+        int const length = static_cast<int>(qc.size());
+        ad.resize(1 + length);
+        kd.resize(    length);
+        kc.resize(    length);
+        int periods_per_year = mode;
+        int months_per_period = 12 / periods_per_year;
+        ad[0] = 1.0;
+        for(int j = 0; j < length; j++)
+            {
+            double f = qc[j] * (1.0 + ic[j]) / (1.0 + ig[j]);
+            double g = 1.0 / (1.0 + f);
+            double i = (ic[j] + ig[j] * f) * g;
+            double q = f * g;
+            if(mce_option2_for_7702 == dbo)
+                {
+                i = i - q;
+                }
+            double v = 1.0 / (1.0 + i);
+            double p = 1.0 - q;
+            double vp = v * p;
+            double vp12 = std::pow(vp, 12);
+            double vpn  = std::pow(vp, periods_per_year);
+            double ka = 1.0;
+            if(1.0 != vp)
+                {
+                ka = (1.0 - vp12) / (1.0 - std::pow(vp, months_per_period));
+                }
+            kd[j] = ka * ad[j];
+            kc[j] = ka * ad[j] * v * q;
+            ad[1 + j] = ad[j] * vpn;
+            }
+        ad.pop_back();
+        }
+
+    std::vector<double> ad;
+    std::vector<double> kd;
+    std::vector<double> kc;
+};
+
+void mete_ul_reference
+    (std::vector<double> const& q
+    ,std::vector<double> const& ic
+    ,std::vector<double> const& ig
+    ,mcenum_mode                mode
+    )
+{
+    ul_reference(q, ic, ig, mce_option1_for_7702, mode);
+}
+
+void mete_ulcf_modal
+    (std::vector<double> const& q
+    ,std::vector<double> const& ic
+    ,std::vector<double> const& ig
+    ,mcenum_mode                mode
+    )
+{
+    ULCommFns(q, ic, ig, mce_option1_for_7702, mode);
+}
+
+/// Test mode-specialized UL commutation functions.
+///
+/// Results must be identical to those of the straightforward
+/// reference implementation for every mode and death benefit option.
+/// Use std::equal() because PETE hijacks operator==() for vectors.
+
+void TestModalULCommFns()
+{
+    std::vector<double> q(sample_q());
+    assign(q, apply_binary(coi_rate_from_q<double>(), q, 1.0 / 11.0));
+    std::vector<double>ic(q.size(), i_upper_12_over_12_from_i<double>()(0.07));
+    std::vector<double>ig(q.size(), i_upper_12_over_12_from_i<double>()(0.03));
+
+    mcenum_mode const modes[] =
+        {mce_annual, mce_semiannual, mce_quarterly, mce_monthly};
+    mcenum_dbopt_7702 const dbos[] =
+        {mce_option1_for_7702, mce_option2_for_7702};
+    for(auto const& m : modes)
+        {
+        for(auto const& b : dbos)
+            {
+            ULCommFns const z(q, ic, ig, b, m);
+            ul_reference const r(q, ic, ig, b, m);
+            BOOST_TEST(std::equal(r.ad.begin(), r.ad.end(), z.aD().begin()));
+            BOOST_TEST(std::equal(r.kd.begin(), r.kd.end(), z.kD().begin()));
+            BOOST_TEST(std::equal(r.kc.begin(), r.kc.end(), z.kC().begin()));
+            }
+        }
+
+    std::cout << "  Speed test: UL commutation functions by mode\n";
+    for(auto const& m : modes)
+        {
+        std::cout
+            << "    mode " << std::setw(2) << m << " reference: "
+            << TimeAnAliquot(std::bind(mete_ul_reference, q, ic, ig, m))
+            << "\n    mode " << std::setw(2) << m << " ULCommFns: "
+            << TimeAnAliquot(std::bind(mete_ulcf_modal, q, ic, ig, m))
+            << '\n'
+            ;
+        }
+    std::cout << std::endl;
+}
+
+/// Test shared UL commutation functions.
+///
+/// Identical arguments must yield the very same instance, which must
+/// match an unshared instance exactly; any difference in arguments
+/// must yield a distinct instance.
+///
+/// Use std::equal() because PETE hijacks operator==() for vectors.
+
+void TestSharedULCommFns()
+{
+    std::vector<double> q(sample_q());
+    std::vector<double>ic(q.size(), i_upper_12_over_12_from_i<double>()(0.04));
+    std::vector<double>ig(q.size(), i_upper_12_over_12_from_i<double>()(0.03));
+
+    std::shared_ptr<ULCommFns const> p0 =
+        shared_ul_comm_fns(q, ic, ig, mce_option1_for_7702, mce_monthly);
+    std::shared_ptr<ULCommFns const> p1 =
+        shared_ul_comm_fns(q, ic, ig, mce_option1_for_7702, mce_monthly);
+    BOOST_TEST(p0 == p1);
+
+    ULCommFns const ulcf(q, ic, ig, mce_option1_for_7702, mce_monthly);
+    BOOST_TEST(std::equal(ulcf.aD().begin(), ulcf.aD().end(), p0->aD().begin()));
+    BOOST_TEST(std::equal(ulcf.kD().begin(), ulcf.kD().end(), p0->kD().begin()));
+    BOOST_TEST(std::equal(ulcf.kC().begin(), ulcf.kC().end(), p0->kC().begin()));
+    BOOST_TEST(std::equal(ulcf.aN().begin(), ulcf.aN().end(), p0->aN().begin()));
+    BOOST_TEST(std::equal(ulcf.kM().begin(), ulcf.kM().end(), p0->kM().begin()));
+    BOOST_TEST_EQUAL(ulcf.aDomega(), p0->aDomega());
+
+    std::shared_ptr<ULCommFns const> p2 =
+        shared_ul_comm_fns(q, ic, ig, mce_option2_for_7702, mce_monthly);
+    BOOST_TEST(p0 != p2);
+
+    std::shared_ptr<ULCommFns const> p3 =
+        shared_ul_comm_fns(q, ic, ig, mce_option1_for_7702, mce_annual);
+    BOOST_TEST(p0 != p3);
+
+    ic[50] = 0.0;
+    std::shared_ptr<ULCommFns const> p4 =
+        shared_ul_comm_fns(q, ic, ig, mce_option1_for_7702, mce_monthly);
+    BOOST_TEST(p0 != p4);
+    BOOST_TEST(!std::equal(p0->aD().begin(), p0->aD().end(), p4->aD().begin()));
+}
+
 int test_main(int, char*[])
 {
     ULCommFnsTest();
     OLCommFnsTest();
     Test_1980_CSO_Male_ANB();
     TestLimits();
+    TestModalULCommFns();
+    TestSharedULCommFns();
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,242 @@
+// Reproducible summation of cell ledgers into a composite.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "composite_reducer.hpp"
+
+#include "assert_lmi.hpp"
+#include "fenv_lmi.hpp"
+#include "ledger.hpp"
+#include "ledger_invariant.hpp"
+
+#include <algorithm>                    // std::min()
+#include <atomic>
+#include <cstddef>                      // std::size_t
+#include <exception>                    // std::exception_ptr
+#include <thread>
+
+/// Prepare to accumulate the given number of cells into 'composite'.
+///
+/// The composite should be freshly constructed: its ledger type and
+/// run bases are those of every partial composite.
+
+composite_reducer::composite_reducer(Ledger& composite, int number_of_cells)
+    :composite_       (composite)
+    ,number_of_cells_ (number_of_cells)
+    ,blocks_          ((number_of_cells + cells_per_block - 1) / cells_per_block)
+{
+    LMI_ASSERT(composite_.is_composite());
+    LMI_ASSERT(0 <= number_of_cells_);
+    for(int j = 0; j < number_of_blocks(); ++j)
+        {
+        blocks_[j].length       = 0;
+        blocks_[j].next_ordinal = j * cells_per_block;
+        }
+}
+
+/// Add a cell to its block.
+///
+/// Within each block, cells must be added in census order. Cells of
+/// distinct blocks may be added concurrently on different threads.
+
+void composite_reducer::add(int ordinal, Ledger const& cell)
+{
+    LMI_ASSERT(0 <= ordinal && ordinal < number_of_cells_);
+    partial_composite& block = blocks_[ordinal / cells_per_block];
+    LMI_ASSERT(ordinal == block.next_ordinal);
+
+    int const length = cell.GetLedgerInvariant().GetLength();
+    if(!block.sum)
+        {
+        partial_composite z = empty_partial(length);
+        z.next_ordinal = block.next_ordinal;
+        block = z;
+        }
+    else if(block.length < length)
+        {
+        // Lengthen the block's vectors to accommodate this cell.
+        partial_composite z = empty_partial(length);
+        z.next_ordinal = block.next_ordinal;
+        absorb(z, block);
+        block = z;
+        }
+    block.sum->accumulate(cell, block.error.get());
+    ++block.next_ordinal;
+}
+
+/// Combine all blocks in a fixed pairwise order, and add the result,
+/// including accumulated rounding errors, to the composite.
+
+void composite_reducer::reduce()
+{
+    std::vector<partial_composite> level;
+    for(int j = 0; j < number_of_blocks(); ++j)
+        {
+        int const end = std::min(number_of_cells_, (1 + j) * cells_per_block);
+        LMI_ASSERT(end == blocks_[j].next_ordinal);
+        level.push_back(blocks_[j]);
+        }
+    blocks_.clear();
+
+    if(level.empty())
+        {
+        return;
+        }
+
+    while(1 < level.size())
+        {
+        std::vector<partial_composite> next_level;
+        for(std::size_t j = 0; j < level.size(); j += 2)
+            {
+            if(j + 1 < level.size())
+                {
+                next_level.push_back(combine(level[j], level[j + 1]));
+                }
+            else
+                {
+                next_level.push_back(level[j]);
+                }
+            }
+        level.swap(next_level);
+        }
+
+    partial_composite const& root = level.front();
+    LMI_ASSERT(root.length <= composite_.GetLedgerInvariant().GetLength());
+    root.sum->add_columns(*root.error);
+    composite_.accumulate(*root.sum, nullptr);
+}
+
+int composite_reducer::number_of_blocks() const
+{
+    return static_cast<int>(blocks_.size());
+}
+
+/// A partial composite of the given length, with no cells.
+
+composite_reducer::partial_composite composite_reducer::empty_partial
+    (int length
+    ) const
+{
+    partial_composite z;
+    z.sum  .reset(new Ledger(length, composite_.ledger_type(), false, false, true));
+    z.error.reset(new Ledger(length, composite_.ledger_type(), false, false, true));
+    z.sum  ->RestrictRunBases(composite_.GetRunBases());
+    z.error->RestrictRunBases(composite_.GetRunBases());
+    z.length       = length;
+    z.next_ordinal = 0;
+    return z;
+}
+
+/// Add the cells of 'from', which follow those of 'into' in census
+/// order, to 'into'.
+
+void composite_reducer::absorb
+    (partial_composite      & into
+    ,partial_composite const& from
+    ) const
+{
+    LMI_ASSERT(from.length <= into.length);
+    into.sum  ->accumulate(*from.sum, into.error.get());
+    into.error->add_columns(*from.error);
+}
+
+/// Combine two partial composites, the earlier one first.
+
+composite_reducer::partial_composite composite_reducer::combine
+    (partial_composite        earlier
+    ,partial_composite const& later
+    ) const
+{
+    if(earlier.length < later.length)
+        {
+        partial_composite z = empty_partial(later.length);
+        absorb(z, earlier);
+        earlier = z;
+        }
+    absorb(earlier, later);
+    return earlier;
+}
+
+/// Sum cells into a composite on the given number of threads.
+///
+/// The result is the same for any number of threads.
+
+void reduce_composite
+    (Ledger&                                           composite
+    ,std::vector<std::shared_ptr<Ledger const>> const& cells
+    ,int                                               number_of_threads
+    )
+{
+    LMI_ASSERT(0 < number_of_threads);
+    composite_reducer reducer(composite, static_cast<int>(cells.size()));
+    int const number_of_blocks = reducer.number_of_blocks();
+
+    std::atomic<int> next_block(0);
+    std::vector<std::exception_ptr> failures(number_of_threads);
+    auto work = [&] (int thread_number)
+        {
+        try
+            {
+            // Initialize each new thread's floating-point environment
+            // as the main thread's was initialized.
+            if(0 != thread_number)
+                {
+                fenv_initialize();
+                }
+            for(int b = next_block++; b < number_of_blocks; b = next_block++)
+                {
+                int const end = std::min
+                    (static_cast<int>(cells.size())
+                    ,(1 + b) * composite_reducer::cells_per_block
+                    );
+                for(int j = b * composite_reducer::cells_per_block; j < end; ++j)
+                    {
+                    reducer.add(j, *cells[j]);
+                    }
+                }
+            }
+        catch(...)
+            {
+            failures[thread_number] = std::current_exception();
+            }
+        };
+
+    std::vector<std::thread> threads;
+    for(int j = 1; j < number_of_threads; ++j)
+        {
+        threads.emplace_back(work, j);
+        }
+    work(0);
+    for(auto& t : threads)
+        {
+        t.join();
+        }
+    for(auto const& f : failures)
+        {
+        if(f)
+            {
+            std::rethrow_exception(f);
+            }
+        }
+
+    reducer.reduce();
+}
@@ -0,0 +1,99 @@
+// Reproducible summation of cell ledgers into a composite.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef composite_reducer_hpp
+#define composite_reducer_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <memory>                       // std::shared_ptr
+#include <vector>
+
+class Ledger;
+
+/// Sum cell ledgers into a composite, reproducibly, on any number of
+/// threads.
+///
+/// Ledger::PlusEq() adds cells one at a time, so its floating-point
+/// result depends on the order of cells, and it cannot be divided
+/// among threads without changing that result. This class instead
+/// assigns cells by census ordinal to blocks of a fixed size. Each
+/// block accumulates its own cells in order; distinct blocks may be
+/// accumulated concurrently. Then reduce() combines blocks pairwise
+/// in a tree whose shape depends only on the number of cells. Sums
+/// are compensated (Neumaier's variant of Kahan summation) at every
+/// step, with rounding errors added back only at the end.
+///
+/// Thus, the composite depends on the cells and their order, but not
+/// on how many threads do the work or which thread handles which
+/// block. It differs from the serial composite only by the rounding
+/// that compensation removes.
+///
+/// Nonadditive values (such as names, or interest rates) are taken
+/// from the last cell, in census order, that has them, exactly as
+/// PlusEq() does.
+
+class LMI_SO composite_reducer final
+{
+  public:
+    enum {cells_per_block = 16};
+
+    composite_reducer(Ledger& composite, int number_of_cells);
+    ~composite_reducer() = default;
+
+    void add(int ordinal, Ledger const& cell);
+    void reduce();
+
+    int number_of_blocks() const;
+
+  private:
+    composite_reducer(composite_reducer const&) = delete;
+    composite_reducer& operator=(composite_reducer const&) = delete;
+
+    struct partial_composite
+    {
+        std::shared_ptr<Ledger> sum;
+        std::shared_ptr<Ledger> error;
+        int                     length;
+        int                     next_ordinal;
+    };
+
+    partial_composite empty_partial(int length) const;
+    void absorb(partial_composite& into, partial_composite const& from) const;
+    partial_composite combine
+        (partial_composite        earlier
+        ,partial_composite const& later
+        ) const;
+
+    Ledger&                        composite_;
+    int                            number_of_cells_;
+    std::vector<partial_composite> blocks_;
+};
+
+void LMI_SO reduce_composite
+    (Ledger&                                           composite
+    ,std::vector<std::shared_ptr<Ledger const>> const& cells
+    ,int                                               number_of_threads
+    );
+
+#endif // composite_reducer_hpp
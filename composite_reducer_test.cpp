@@ -0,0 +1,281 @@
+// Reproducible summation of cell ledgers into a composite: unit test.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "composite_reducer.hpp"
+
+#include "ledger.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "materially_equal.hpp"
+#include "test_tools.hpp"
+
+#include <cstddef>                      // std::size_t
+#include <memory>                       // std::shared_ptr
+#include <vector>
+
+namespace
+{
+int const composite_length = 50;
+
+/// Deterministic pseudorandom values with widely varying magnitudes,
+/// so that naive summation incurs rounding errors.
+
+class value_generator
+{
+  public:
+    explicit value_generator(unsigned int seed) : state_(seed) {}
+
+    double operator()()
+        {
+        state_ = 1664525u * state_ + 1013904223u;
+        double const fraction = (state_ >> 8) / 16777216.0;
+        static double const scale[] = {0.01, 1.0, 1000.0, 1.0e6};
+        return fraction * scale[state_ % 4];
+        }
+
+  private:
+    unsigned int state_;
+};
+
+std::shared_ptr<Ledger const> make_cell(int ordinal)
+{
+    int const length = composite_length - ordinal % 20;
+    int const lapse_year = (0 == ordinal % 7) ? length / 2 : length;
+    value_generator next(static_cast<unsigned int>(1 + ordinal));
+
+    std::shared_ptr<Ledger> cell
+        (new Ledger(length, mce_ill_reg, false, false, false)
+        );
+
+    LedgerInvariant invariant(length);
+    for(int j = 0; j <= length; ++j)
+        {
+        invariant.InforceLives[j] = (j <= lapse_year) ? 1 + ordinal % 3 : 0;
+        }
+    for(int j = 0; j < length; ++j)
+        {
+        invariant.GrossPmt[j] = next();
+        invariant.SpecAmt [j] = next();
+        }
+    invariant.irr_precision = ordinal;
+    cell->SetLedgerInvariant(invariant);
+
+    for(auto const& basis : cell->GetRunBases())
+        {
+        LedgerVariant variant(length);
+        variant.set_run_basis(basis);
+        for(int j = 0; j < length; ++j)
+            {
+            variant.COICharge   [j] = next();
+            variant.AcctVal     [j] = next();
+            variant.AnnGAIntRate[j] = next();
+            }
+        variant.LapseYear = lapse_year;
+        cell->SetOneLedgerVariant(basis, variant);
+        }
+    return cell;
+}
+
+std::vector<std::shared_ptr<Ledger const>> make_cells(int number_of_cells)
+{
+    std::vector<std::shared_ptr<Ledger const>> cells;
+    for(int j = 0; j < number_of_cells; ++j)
+        {
+        cells.push_back(make_cell(j));
+        }
+    return cells;
+}
+
+std::shared_ptr<Ledger> empty_composite()
+{
+    return std::shared_ptr<Ledger>
+        (new Ledger(composite_length, mce_ill_reg, false, false, true)
+        );
+}
+
+std::shared_ptr<Ledger> serial_composite
+    (std::vector<std::shared_ptr<Ledger const>> const& cells
+    )
+{
+    std::shared_ptr<Ledger> composite = empty_composite();
+    for(auto const& i : cells)
+        {
+        composite->PlusEq(*i);
+        }
+    return composite;
+}
+
+std::shared_ptr<Ledger> reduced_composite
+    (std::vector<std::shared_ptr<Ledger const>> const& cells
+    ,int                                               number_of_threads
+    )
+{
+    std::shared_ptr<Ledger> composite = empty_composite();
+    reduce_composite(*composite, cells, number_of_threads);
+    return composite;
+}
+
+/// Every numeric vector of a ledger, in a fixed order.
+
+std::vector<std::vector<double>> all_values(Ledger const& ledger)
+{
+    std::vector<std::vector<double>> z;
+    for(auto const& i : ledger.GetLedgerInvariant().all_vectors())
+        {
+        z.push_back(*i.second);
+        }
+    for(auto const& basis : ledger.GetLedgerMap().held())
+        {
+        for(auto const& i : basis.second.all_vectors())
+            {
+            z.push_back(*i.second);
+            }
+        }
+    return z;
+}
+
+bool identical(Ledger const& a, Ledger const& b)
+{
+    std::vector<std::vector<double>> const x = all_values(a);
+    std::vector<std::vector<double>> const y = all_values(b);
+    if(x.size() != y.size())
+        {
+        return false;
+        }
+    for(std::size_t j = 0; j < x.size(); ++j)
+        {
+        if(x[j].size() != y[j].size())
+            {
+            return false;
+            }
+        for(std::size_t k = 0; k < x[j].size(); ++k)
+            {
+            if(x[j][k] != y[j][k])
+                {
+                return false;
+                }
+            }
+        }
+    return true;
+}
+
+bool materially_identical(Ledger const& a, Ledger const& b)
+{
+    std::vector<std::vector<double>> const x = all_values(a);
+    std::vector<std::vector<double>> const y = all_values(b);
+    if(x.size() != y.size())
+        {
+        return false;
+        }
+    for(std::size_t j = 0; j < x.size(); ++j)
+        {
+        if(x[j].size() != y[j].size())
+            {
+            return false;
+            }
+        for(std::size_t k = 0; k < x[j].size(); ++k)
+            {
+            if(!materially_equal(x[j][k], y[j][k]))
+                {
+                return false;
+                }
+            }
+        }
+    return true;
+}
+} // Unnamed namespace.
+
+int test_main(int, char*[])
+{
+    // The composite is the same regardless of the number of threads,
+    // and materially equal to the serial composite.
+
+    std::vector<std::shared_ptr<Ledger const>> const cells = make_cells(101);
+    std::shared_ptr<Ledger> const serial = serial_composite(cells);
+    std::shared_ptr<Ledger> const single = reduced_composite(cells, 1);
+    BOOST_TEST(materially_identical(*serial, *single));
+    for(int threads = 2; threads <= 8; ++threads)
+        {
+        BOOST_TEST(identical(*single, *reduced_composite(cells, threads)));
+        }
+
+    // Nonadditive values come from the last cell that has them, just
+    // as in the serial composite.
+
+    BOOST_TEST_EQUAL
+        (serial->GetLedgerInvariant().irr_precision
+        ,single->GetLedgerInvariant().irr_precision
+        );
+    std::vector<double> const& serial_rate = serial->GetCurrFull().AnnGAIntRate;
+    std::vector<double> const& single_rate = single->GetCurrFull().AnnGAIntRate;
+    BOOST_TEST(serial_rate.size() == single_rate.size());
+    for(std::size_t j = 0; j < serial_rate.size(); ++j)
+        {
+        BOOST_TEST_EQUAL(serial_rate[j], single_rate[j]);
+        }
+    BOOST_TEST_EQUAL
+        (serial->GetCurrFull().LapseYear
+        ,single->GetCurrFull().LapseYear
+        );
+
+    // Compensated summation recovers small addends that naive serial
+    // summation loses: 2^53 + 1 rounds to 2^53, but 2^53 + 32 ones
+    // is exactly representable.
+
+    std::vector<std::shared_ptr<Ledger const>> ones;
+    for(int j = 0; j < 33; ++j)
+        {
+        std::shared_ptr<Ledger> cell
+            (new Ledger(composite_length, mce_ill_reg, false, false, false)
+            );
+        LedgerInvariant invariant(composite_length);
+        invariant.InforceLives.assign(1 + composite_length, 1.0);
+        invariant.GrossPmt[0] = (0 == j) ? 9007199254740992.0 : 1.0;
+        cell->SetLedgerInvariant(invariant);
+        ones.push_back(cell);
+        }
+    BOOST_TEST_EQUAL
+        (9007199254740992.0
+        ,serial_composite(ones)->GetLedgerInvariant().GrossPmt[0]
+        );
+    BOOST_TEST_EQUAL
+        (9007199254741024.0
+        ,reduced_composite(ones, 3)->GetLedgerInvariant().GrossPmt[0]
+        );
+
+    // A cell cannot be added out of order within its block.
+
+    std::shared_ptr<Ledger> composite = empty_composite();
+    composite_reducer reducer(*composite, 2);
+    BOOST_TEST_THROW
+        (reducer.add(1, *cells[1])
+        ,std::runtime_error
+        ,"Assertion 'ordinal == block.next_ordinal' failed."
+        );
+
+    // An empty census yields an empty composite.
+
+    BOOST_TEST(identical(*empty_composite(), *reduced_composite(make_cells(0), 4)));
+
+    return EXIT_SUCCESS;
+}
@@ -132,7 +132,7 @@ class currency
 
     int cents() const
         {
-        return cents_ % cents_per_dollar;
+        return static_cast<int>(cents_ % cents_per_dollar);
         }
 
     /// Total number of cents, e.g., 123 for 1 dollar and 23 cents.
@@ -146,7 +146,7 @@ class currency
 
     double value() const
         {
-        double result = cents_;
+        double result = static_cast<double>(cents_);
         result /= cents_per_dollar;
         return result;
         }
@@ -0,0 +1,215 @@
+// Census whose cells are stored as differences from their defaults.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "delta_census.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+
+#include <algorithm>                    // std::lower_bound()
+#include <cstddef>                      // std::size_t
+#include <utility>                      // std::make_pair(), std::move()
+
+/// Construct an empty census with the given defaults.
+///
+/// If two class defaults have the same EmployeeClass, cells of that
+/// class are encoded against the first.
+
+delta_census::delta_census
+    (Input              const& case_default
+    ,std::vector<Input> const& class_defaults
+    )
+    :case_default_   (case_default)
+    ,class_defaults_ (class_defaults)
+{
+    std::vector<std::string> const& names = member_names();
+    int const number_of_defaults = 1 + static_cast<int>(class_defaults_.size());
+    default_values_.reserve(number_of_defaults);
+    for(int j = 0; j < number_of_defaults; ++j)
+        {
+        std::vector<std::string> values;
+        values.reserve(names.size());
+        for(auto const& k : names)
+            {
+            values.push_back(default_cell(j)[k].str());
+            }
+        default_values_.push_back(values);
+        if(0 != j)
+            {
+            class_index_.insert
+                (std::make_pair(default_cell(j)["EmployeeClass"].str(), j)
+                );
+            }
+        }
+}
+
+void delta_census::push_back(Input const& cell)
+{
+    cells_.push_back(encode(cell));
+}
+
+void delta_census::replace(int index, Input const& cell)
+{
+    LMI_ASSERT(0 <= index && index < size());
+    cells_[index] = encode(cell);
+}
+
+int delta_census::size() const
+{
+    return static_cast<int>(cells_.size());
+}
+
+bool delta_census::empty() const
+{
+    return cells_.empty();
+}
+
+delta_census::cell_view delta_census::operator[](int index) const
+{
+    LMI_ASSERT(0 <= index && index < size());
+    return cell_view(*this, index);
+}
+
+Input const& delta_census::case_default() const
+{
+    return case_default_;
+}
+
+std::vector<Input> const& delta_census::class_defaults() const
+{
+    return class_defaults_;
+}
+
+/// Materialize every cell, e.g., for code that requires a complete
+/// std::vector<Input>.
+
+std::vector<Input> delta_census::materialize_all() const
+{
+    std::vector<Input> z;
+    z.reserve(cells_.size());
+    for(int j = 0; j < size(); ++j)
+        {
+        z.push_back(operator[](j).materialize());
+        }
+    return z;
+}
+
+/// Total number of values stored for all cells.
+
+int delta_census::number_of_differences() const
+{
+    int z = 0;
+    for(auto const& i : cells_)
+        {
+        z += static_cast<int>(i.differences.size());
+        }
+    return z;
+}
+
+/// Encode a cell as differences from its default.
+
+delta_census::sparse_cell delta_census::encode(Input const& cell) const
+{
+    auto const c = class_index_.find(cell["EmployeeClass"].str());
+    sparse_cell z;
+    z.base = (class_index_.end() == c) ? 0 : c->second;
+
+    std::vector<std::string> const& names = member_names();
+    std::vector<std::string> const& base_values = default_values_[z.base];
+    for(std::size_t j = 0; j < names.size(); ++j)
+        {
+        std::string value = cell[names[j]].str();
+        if(value != base_values[j])
+            {
+            z.differences.push_back({static_cast<int>(j), std::move(value)});
+            }
+        }
+    z.differences.shrink_to_fit();
+    return z;
+}
+
+Input const& delta_census::default_cell(int base) const
+{
+    return (0 == base) ? case_default_ : class_defaults_[base - 1];
+}
+
+/// Names of all members of class Input, in the order used to index
+/// differences.
+
+std::vector<std::string> const& delta_census::member_names() const
+{
+    return case_default_.member_names();
+}
+
+delta_census::cell_view::cell_view(delta_census const& census, int index)
+    :census_ (census)
+    ,cell_   (census.cells_[index])
+{
+}
+
+/// Value of the named member, as a string, without materializing
+/// the cell.
+
+std::string const& delta_census::cell_view::operator[]
+    (std::string const& name
+    ) const
+{
+    std::vector<std::string> const& names = census_.member_names();
+    auto const i = std::lower_bound(names.begin(), names.end(), name);
+    if(names.end() == i || name != *i)
+        {
+        alarum() << "Symbol table for class Input"
+            << " ascribes no member named '"
+            << name
+            << "'."
+            << LMI_FLUSH
+            ;
+        }
+    int const member = static_cast<int>(i - names.begin());
+    for(auto const& j : cell_.differences)
+        {
+        if(member == j.member)
+            {
+            return j.value;
+            }
+        }
+    return census_.default_values_[cell_.base][member];
+}
+
+/// Construct the complete Input that this cell represents.
+
+Input delta_census::cell_view::materialize() const
+{
+    std::vector<std::string> const& names = census_.member_names();
+    Input z(census_.default_cell(cell_.base));
+    for(auto const& j : cell_.differences)
+        {
+        z[names[j.member]] = j.value;
+        }
+    return z;
+}
+
+int delta_census::cell_view::number_of_differences() const
+{
+    return static_cast<int>(cell_.differences.size());
+}
@@ -0,0 +1,134 @@
+// Census whose cells are stored as differences from their defaults.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef delta_census_hpp
+#define delta_census_hpp
+
+#include "config.hpp"
+
+#include "input.hpp"
+#include "so_attributes.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+/// A census whose cells are stored sparsely.
+///
+/// Each cell is represented by its default--the class default whose
+/// name is the cell's EmployeeClass, or else the case default--and
+/// the values of those members of class Input that differ from that
+/// default. Typically only a dozen or so of an Input's two hundred
+/// members differ, so a large census occupies a small fraction of
+/// the memory that a std::vector<Input> would.
+///
+/// Values are stored as the strings that multiple_cell_document
+/// writes, so materializing a cell reproduces it exactly: the result
+/// compares equal to the Input from which the cell was made.
+///
+/// A census is usually read by multiple_cell_document::read_delta_census(),
+/// which encodes each cell as it is read, so that a std::vector<Input>
+/// of all cells is never held in memory.
+///
+/// Implicitly-declared special member functions do the right thing.
+
+class LMI_SO delta_census final
+{
+  public:
+    class cell_view;
+
+    delta_census
+        (Input              const& case_default
+        ,std::vector<Input> const& class_defaults
+        );
+
+    void push_back(Input const&);
+    void replace(int index, Input const&);
+
+    int size() const;
+    bool empty() const;
+    cell_view operator[](int index) const;
+
+    Input              const& case_default  () const;
+    std::vector<Input> const& class_defaults() const;
+
+    std::vector<Input> materialize_all() const;
+
+    int number_of_differences() const;
+
+  private:
+    /// A member's index in Input::member_names(), and its value.
+    struct difference
+    {
+        int         member;
+        std::string value;
+    };
+
+    /// A cell: the index of its default (zero for the case default,
+    /// or one plus an index into class_defaults_), and the ways it
+    /// differs from that default.
+    struct sparse_cell
+    {
+        int                     base;
+        std::vector<difference> differences;
+    };
+
+    sparse_cell encode(Input const&) const;
+
+    Input const& default_cell(int base) const;
+
+    std::vector<std::string> const& member_names() const;
+
+    Input                                 case_default_;
+    std::vector<Input>                    class_defaults_;
+    // String value of each member of each default, indexed by base.
+    std::vector<std::vector<std::string>> default_values_;
+    // Base for each class name.
+    std::map<std::string,int>             class_index_;
+    std::vector<sparse_cell>              cells_;
+};
+
+/// A lightweight view of one cell of a delta_census.
+///
+/// Individual values are looked up without constructing an Input;
+/// materialize() constructs a complete Input when a calculation
+/// needs one. A view refers to its census, so it must not outlive
+/// that census, or any replace() of its cell.
+
+class LMI_SO delta_census::cell_view final
+{
+    friend class delta_census;
+
+  public:
+    std::string const& operator[](std::string const& name) const;
+
+    Input materialize() const;
+
+    int number_of_differences() const;
+
+  private:
+    cell_view(delta_census const&, int index);
+
+    delta_census const& census_;
+    sparse_cell  const& cell_;
+};
+
+#endif // delta_census_hpp
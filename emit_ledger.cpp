@@ -23,10 +23,12 @@
 
 #include "emit_ledger.hpp"
 
+#include "alert.hpp"
 #include "assert_lmi.hpp"
 #include "configurable_settings.hpp"
 #include "custom_io_0.hpp"
 #include "custom_io_1.hpp"
+#include "fenv_lmi.hpp"
 #include "file_command.hpp"
 #include "group_quote_pdf_gen.hpp"
 #include "ledger.hpp"
@@ -39,9 +41,15 @@
 #include <boost/filesystem/convenience.hpp> // change_extension()
 #include <boost/filesystem/fstream.hpp>
 
+#include <atomic>
 #include <iostream>
 #include <string>
 
+namespace
+{
+std::atomic<bool> asynchronous_emission {false};
+} // Unnamed namespace.
+
 /// Emit a group of ledgers in various guises.
 ///
 /// The ledgers constitute a 'case' consisting of 'cells' as those
@@ -126,6 +134,21 @@ double ledger_emitter::emit_cell
             );
         ledger.Spew(ofs);
         }
+    if(emission_ & mce_emit_binary_ledger)
+        {
+        fs::path const binary_filepath = fs::change_extension(cell_filepath, ".ledger");
+        if(binary_filepath == cell_filepath)
+            {
+            alarum()
+                << "Binary ledger output would overwrite input file '"
+                << cell_filepath.string()
+                << "'."
+                << LMI_FLUSH
+                ;
+            }
+        fs::ofstream ofs(binary_filepath, ios_out_trunc_binary());
+        ledger.write_binary(ofs);
+        }
     if(emission_ & mce_emit_spreadsheet)
         {
         PrintCellTabDelimited(ledger, case_filepath_spreadsheet_.string());
@@ -181,6 +204,154 @@ double ledger_emitter::finish()
     return timer.stop().elapsed_seconds();
 }
 
+/// Start the worker thread, which waits for ledgers to emit.
+
+asynchronous_ledger_emitter::asynchronous_ledger_emitter
+    (ledger_emitter& emitter
+    ,std::size_t     capacity
+    )
+    :emitter_            (emitter)
+    ,capacity_           (capacity)
+    ,busy_               (false)
+    ,closed_             (false)
+    ,seconds_for_output_ (0.0)
+{
+    LMI_ASSERT(0 < capacity_);
+    worker_ = std::thread(&asynchronous_ledger_emitter::run, this);
+}
+
+asynchronous_ledger_emitter::~asynchronous_ledger_emitter()
+{
+    {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    }
+    changed_.notify_all();
+    worker_.join();
+}
+
+/// Queue a ledger for emission.
+///
+/// Return time spent waiting for the queue to have room, which is
+/// time that could not be spent calculating.
+
+double asynchronous_ledger_emitter::emit_cell
+    (fs::path const&               cell_filepath
+    ,std::shared_ptr<Ledger const> ledger
+    )
+{
+    Timer timer;
+    {
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait
+        (lock
+        ,[this] {return failure_ || pending_.size() < capacity_;}
+        );
+    rethrow_if_failed();
+    pending_.emplace_back(cell_filepath, ledger);
+    }
+    changed_.notify_all();
+    return timer.stop().elapsed_seconds();
+}
+
+/// Wait until every queued ledger has been emitted.
+///
+/// Return time spent waiting.
+
+double asynchronous_ledger_emitter::wait()
+{
+    Timer timer;
+    std::unique_lock<std::mutex> lock(mutex_);
+    changed_.wait
+        (lock
+        ,[this] {return failure_ || (pending_.empty() && !busy_);}
+        );
+    rethrow_if_failed();
+    return timer.stop().elapsed_seconds();
+}
+
+/// Total time the worker thread has spent emitting ledgers.
+
+double asynchronous_ledger_emitter::seconds_for_output() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return seconds_for_output_;
+}
+
+/// Emit queued ledgers until closed and drained, or until failure.
+///
+/// The floating-point environment is initialized here as it is for
+/// the main thread, so that formatting is unaffected by the thread
+/// on which it happens.
+
+void asynchronous_ledger_emitter::run()
+{
+    fenv_initialize();
+    std::unique_lock<std::mutex> lock(mutex_);
+    for(;;)
+        {
+        changed_.wait(lock, [this] {return closed_ || !pending_.empty();});
+        if(pending_.empty() || failure_)
+            {
+            return;
+            }
+        cell_type const cell = pending_.front();
+        pending_.pop_front();
+        busy_ = true;
+        lock.unlock();
+        changed_.notify_all();
+        double seconds = 0.0;
+        std::exception_ptr failure;
+        try
+            {
+            seconds = emitter_.emit_cell(cell.first, *cell.second);
+            }
+        catch(...)
+            {
+            failure = std::current_exception();
+            }
+        lock.lock();
+        busy_ = false;
+        seconds_for_output_ += seconds;
+        if(failure)
+            {
+            failure_ = failure;
+            pending_.clear();
+            }
+        changed_.notify_all();
+        }
+}
+
+/// Rethrow an exception caught on the worker thread, if any.
+///
+/// Precondition: mutex_ is locked.
+
+void asynchronous_ledger_emitter::rethrow_if_failed()
+{
+    if(failure_)
+        {
+        std::rethrow_exception(failure_);
+        }
+}
+
+/// Declare whether the alert, system-command, and file-command
+/// implementations that this program installs may be called from
+/// any thread, so that census output may be emitted on a separate
+/// thread by class asynchronous_ledger_emitter.
+///
+/// Only non-wx programs may declare so: wx functions may be called
+/// only on the main thread. By default, emission is synchronous.
+
+void permit_asynchronous_emission(bool permitted)
+{
+    asynchronous_emission = permitted;
+}
+
+bool asynchronous_emission_permitted()
+{
+    return asynchronous_emission;
+}
+
 /// Emit a single ledger in various guises.
 ///
 /// Return time spent, which is almost always wanted.
@@ -203,3 +374,51 @@ double emit_ledger
     return emitter.emit_cell(cell_filepath, ledger);
 }
 
+/// Run bases whose values the given emission reads.
+///
+/// Pass the result to Ledger::RestrictRunBases() to avoid calculating
+/// values that would only be discarded. Each emission type declares
+/// the bases it reads here, and the result is their union. Types that
+/// might read any basis, such as PDF output, require all bases.
+///
+/// mce_emit_nothing is also taken to require all bases, because it is
+/// used when a ledger is to be retained for display or printing later.
+
+std::vector<mcenum_run_basis> run_bases_required(mcenum_emission emission)
+{
+    static std::vector<mcenum_run_basis> const all_bases =
+        {mce_run_gen_curr_sep_full
+        ,mce_run_gen_guar_sep_full
+        ,mce_run_gen_mdpt_sep_full
+        ,mce_run_gen_curr_sep_zero
+        ,mce_run_gen_guar_sep_zero
+        ,mce_run_gen_curr_sep_half
+        ,mce_run_gen_guar_sep_half
+        };
+    static std::vector<mcenum_run_basis> const current_only =
+        {mce_run_gen_curr_sep_full
+        };
+
+    // Options that modify how output is produced, but produce none.
+    int const modifiers =
+          mce_emit_composite_only
+        | mce_emit_quietly
+        | mce_emit_timings
+        | mce_emit_low_memory
+        ;
+    // Output that reads only current values.
+    int const current_only_output =
+          mce_emit_group_roster
+        | mce_emit_group_quote
+        | mce_emit_custom_0
+        | mce_emit_custom_1
+        ;
+
+    int const output = emission & ~modifiers;
+    bool const wants_current_only =
+           0 != output
+        && 0 == (output & ~current_only_output)
+        ;
+    return wants_current_only ? current_only : all_bases;
+}
+
@@ -29,7 +29,21 @@
 
 #include <boost/filesystem/path.hpp>
 
+#include <condition_variable>
+#include <cstddef>                      // std::size_t
+#include <deque>
+#include <exception>                    // std::exception_ptr
 #include <memory>                       // std::shared_ptr
+#include <mutex>
+#include <thread>
+#include <utility>                      // std::pair
+#include <vector>
+
+// MinGW-w64 provides std::thread only in toolchains built with posix
+// threads; with win32 threads, <thread> silently declares nothing.
+#if defined __MINGW32__ && !defined _GLIBCXX_HAS_GTHREADS
+#   error std::thread requires a MinGW-w64 toolchain with posix threads.
+#endif // defined __MINGW32__ && !defined _GLIBCXX_HAS_GTHREADS
 
 class group_quote_pdf_generator;
 class Ledger;
@@ -65,11 +79,78 @@ class LMI_SO ledger_emitter final
     std::shared_ptr<group_quote_pdf_generator> group_quote_gen_;
 };
 
+/// Emit ledgers on a separate thread, in the order they're given.
+///
+/// Calculation need not wait for formatting, file I/O, or external
+/// programs such as fop: the caller hands off each finished ledger,
+/// and a single worker thread passes it to ledger_emitter::emit_cell().
+/// Only one worker is used because emit_cell() appends to case-level
+/// files, and must therefore be called serially in cell order.
+///
+/// At most 'capacity' ledgers await emission at any time; emit_cell()
+/// blocks while that many are pending, which bounds memory usage.
+///
+/// Emission calls system_command(), file_command(), and status(),
+/// whose wx implementations may be called only on the main thread.
+/// Therefore, this class is used only if a program that installs
+/// thread-safe implementations of those functions has declared so
+/// by calling permit_asynchronous_emission(); otherwise, ledgers are
+/// emitted synchronously, as they always were.
+///
+/// std::thread requires a MinGW-w64 toolchain built with posix
+/// threads; building with win32 threads fails with an explicit
+/// diagnostic above.
+///
+/// An exception thrown on the worker thread stops emission and is
+/// rethrown on the calling thread by the next call to emit_cell() or
+/// wait(). The dtor stops the worker after emitting pending ledgers,
+/// but swallows any exception, so wait() should be called to learn
+/// whether everything was emitted.
+
+class LMI_SO asynchronous_ledger_emitter final
+{
+  public:
+    asynchronous_ledger_emitter(ledger_emitter&, std::size_t capacity);
+    ~asynchronous_ledger_emitter();
+
+    double emit_cell(fs::path const&, std::shared_ptr<Ledger const>);
+    double wait();
+
+    double seconds_for_output() const;
+
+  private:
+    asynchronous_ledger_emitter(asynchronous_ledger_emitter const&) = delete;
+    asynchronous_ledger_emitter& operator=(asynchronous_ledger_emitter const&) = delete;
+
+    typedef std::pair<fs::path,std::shared_ptr<Ledger const>> cell_type;
+
+    void run();
+    void rethrow_if_failed();
+
+    ledger_emitter&         emitter_;
+    std::size_t const       capacity_;
+
+    mutable std::mutex      mutex_;
+    std::condition_variable changed_;
+    std::deque<cell_type>   pending_;
+    bool                    busy_;
+    bool                    closed_;
+    std::exception_ptr      failure_;
+    double                  seconds_for_output_;
+
+    std::thread             worker_;
+};
+
+void LMI_SO permit_asynchronous_emission(bool);
+bool LMI_SO asynchronous_emission_permitted();
+
 double LMI_SO emit_ledger
     (fs::path const& cell_filepath
     ,Ledger const&   ledger
     ,mcenum_emission emission
     );
 
+std::vector<mcenum_run_basis> LMI_SO run_bases_required(mcenum_emission);
+
 #endif // emit_ledger_hpp
 
@@ -29,6 +29,7 @@
 #include "miscellany.hpp"               // minmax
 
 #include <algorithm>                    // std::min_element()
+#include <memory>                       // std::shared_ptr
 #include <numeric>                      // std::partial_sum()
 #include <stdexcept>
 
@@ -138,7 +139,9 @@ gpt_commfns::gpt_commfns
     mm m(charges.qab_child_rate      ); LMI_ASSERT(0.0 <= m && m <  1.0);
     mm n(charges.qab_waiver_rate     ); LMI_ASSERT(0.0 <= n && n <  1.0);
 
-    ULCommFns const cf(qc, ic, ig, dbo, mce_monthly);
+    std::shared_ptr<ULCommFns const> const shared_cf =
+        shared_ul_comm_fns(qc, ic, ig, dbo, mce_monthly);
+    ULCommFns const& cf = *shared_cf;
 
     M_                    = cf.kM();
     D_endt_               = cf.aDomega();
@@ -57,6 +57,7 @@
 #include <algorithm>                    // std::min()
 #include <iostream>
 #include <limits>
+#include <memory>                       // std::shared_ptr
 #include <string>
 #include <vector>
 
@@ -222,13 +223,14 @@ gpt_state test_one_days_gpt_transactions
         ? zero
         : Mly7702iGlp
         ;
-    ULCommFns commfns
+    std::shared_ptr<ULCommFns const> const shared_commfns = shared_ul_comm_fns
         (Mly7702qc
         ,Mly7702iGlp
         ,naar_disc_rate
         ,mce_option1_for_7702
         ,mce_monthly
         );
+    ULCommFns const& commfns = *shared_commfns;
 
     std::vector<double> analytic_Ax(input.years_to_maturity());
     analytic_Ax += (commfns.aDomega() + commfns.kM()) / commfns.aD();
@@ -28,6 +28,7 @@
 #include "assert_lmi.hpp"
 #include "configurable_settings.hpp"
 #include "contains.hpp"
+#include "delta_census.hpp"
 #include "emit_ledger.hpp"
 #include "fenv_guard.hpp"
 #include "input.hpp"
@@ -35,22 +36,80 @@
 #include "ledgervalues.hpp"
 #include "materially_equal.hpp"
 #include "mc_enum_types_aux.hpp"        // mc_str()
-#include "path_utility.hpp"
+#include "miscellany.hpp"               // ios_in_binary(), ios_in_out_trunc_binary(), ios_out_trunc_binary()
+#include "path_utility.hpp"             // unique_filepath()
 #include "progress_meter.hpp"
 #include "timer.hpp"
 #include "value_cast.hpp"
 
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>  // is_directory(), remove()
+
 #include <algorithm>                    // std::max()
+#include <cstddef>                      // std::size_t
+#include <cstdlib>                      // std::getenv()
+#include <functional>                   // std::function
+#include <ios>                          // std::streamoff
 #include <iterator>                     // std::back_inserter()
+#include <map>
+#include <memory>                       // std::unique_ptr
 #include <string>
+#include <vector>
 
 namespace
 {
-bool cell_should_be_ignored(Input const& cell)
+/// Uniform access to the cells of a census, whether it is stored as
+/// a std::vector<Input> or as a delta_census.
+///
+/// A delta_census cell is materialized only when a calculation needs
+/// a complete Input, and the result is discarded soon afterward, so
+/// that no more than a few complete cells exist at any time. Values
+/// of single fields are looked up without materializing anything.
+
+int number_of_cells(std::vector<Input> const& cells)
+{
+    return static_cast<int>(cells.size());
+}
+
+int number_of_cells(delta_census const& cells)
+{
+    return cells.size();
+}
+
+std::string cell_field
+    (std::vector<Input> const& cells
+    ,int                       j
+    ,std::string        const& name
+    )
+{
+    return cells[j][name].str();
+}
+
+std::string cell_field
+    (delta_census       const& cells
+    ,int                       j
+    ,std::string        const& name
+    )
+{
+    return cells[j][name];
+}
+
+Input const& cell_input(std::vector<Input> const& cells, int j)
+{
+    return cells[j];
+}
+
+Input cell_input(delta_census const& cells, int j)
+{
+    return cells[j].materialize();
+}
+
+template<typename Census>
+bool cell_should_be_ignored(Census const& cells, int j)
 {
     return
-            0     == value_cast<int>(cell["NumberOfIdenticalLives"].str())
-        ||  "Yes" !=                 cell["IncludeInComposite"    ].str()
+            0     == value_cast<int>(cell_field(cells, j, "NumberOfIdenticalLives"))
+        ||  "Yes" !=                 cell_field(cells, j, "IncludeInComposite"    )
         ;
 }
 
@@ -71,6 +130,13 @@ int intermission_between_printouts(mcenum_emission emission)
     return (emission & mce_emit_pdf_to_printer) ? pause : 0;
 }
 
+/// Number of calculated ledgers that may await emission.
+///
+/// Calculation rarely gets far ahead of emission for long, so a few
+/// ledgers suffice to keep both busy; more would only use memory.
+
+std::size_t const pending_ledgers_limit = 4;
+
 progress_meter::enum_display_mode progress_meter_mode(mcenum_emission emission)
 {
     return (emission & mce_emit_quietly)
@@ -78,6 +144,294 @@ progress_meter::enum_display_mode progress_meter_mode(mcenum_emission emission)
         : progress_meter::e_normal_display
         ;
 }
+
+/// Number of finished cells' ledgers to hold in memory while they
+/// await their turn to be composited and emitted; others are spilled
+/// to disk.
+
+std::size_t const retained_ledgers_limit = 64;
+
+/// Directory for ledgers spilled to disk.
+///
+/// Spilled files are transient, so they belong in the system's
+/// temporary directory, not among the user's output. If none is
+/// named in the environment, use the directory that already holds
+/// other intermediate files.
+
+fs::path spill_directory()
+{
+    for(char const* name : {"TMPDIR", "TMP", "TEMP"})
+        {
+        char const* z = std::getenv(name);
+        if(z && *z && fs::is_directory(fs::path(z)))
+            {
+            return fs::path(z);
+            }
+        }
+    return fs::path(configurable_settings::instance().print_directory());
+}
+
+/// Composite and emit the ledgers of finished cells in census order.
+///
+/// Cells in a census run month by month finish at different times:
+/// those that lapse or mature early need no further calculation.
+/// Each finished cell's ledger is added here, and as soon as every
+/// preceding cell has finished too, it is added to the composite,
+/// emitted, and discarded. Thus, the composite is summed and case-
+/// level files are written in census order, exactly as though all
+/// cells had finished together.
+///
+/// Cells are retired early only in low-memory mode (see
+/// mce_emit_low_memory); otherwise, all are added here after the last
+/// basis has been run.
+///
+/// Ledgers that must wait are held in memory, up to a limit; beyond
+/// that limit, they're written to a temporary directory in binary
+/// format and read back when needed. Any spilled files that remain
+/// upon destruction (e.g., after cancellation) are removed.
+
+class retired_cell_ledgers final
+{
+  public:
+    retired_cell_ledgers
+        (Ledger                                & composite
+        ,ledger_emitter                        & emitter
+        ,fs::path                         const& file
+        ,std::function<std::string(int)>  const& insured_name
+        ,std::size_t                             memory_limit
+        ,int                                     pause
+        );
+    ~retired_cell_ledgers();
+
+    double add
+        (int                             ordinal
+        ,std::shared_ptr<Ledger const>   ledger
+        ,progress_meter                & meter
+        );
+
+    int next() const {return next_;}
+
+  private:
+    retired_cell_ledgers(retired_cell_ledgers const&) = delete;
+    retired_cell_ledgers& operator=(retired_cell_ledgers const&) = delete;
+
+    fs::path cell_filepath(int ordinal) const;
+    fs::path spill_filepath(int ordinal) const;
+    double flush(progress_meter&);
+
+    Ledger                                & composite_;
+    ledger_emitter                        & emitter_;
+    fs::path                         const& file_;
+    std::function<std::string(int)>  const  insured_name_;
+    std::size_t                      const  memory_limit_;
+    int                              const  pause_;
+
+    int                                          next_;
+    std::map<int,std::shared_ptr<Ledger const>> in_memory_;
+    std::map<int,fs::path>                       on_disk_;
+};
+
+retired_cell_ledgers::retired_cell_ledgers
+    (Ledger                                & composite
+    ,ledger_emitter                        & emitter
+    ,fs::path                         const& file
+    ,std::function<std::string(int)>  const& insured_name
+    ,std::size_t                             memory_limit
+    ,int                                     pause
+    )
+    :composite_    (composite)
+    ,emitter_      (emitter)
+    ,file_         (file)
+    ,insured_name_ (insured_name)
+    ,memory_limit_ (memory_limit)
+    ,pause_        (pause)
+    ,next_         (0)
+{
+}
+
+retired_cell_ledgers::~retired_cell_ledgers()
+{
+    for(auto const& i : on_disk_)
+        {
+        try
+            {
+            fs::remove(i.second);
+            }
+        catch(...)
+            {
+            // A leftover temporary file is harmless.
+            }
+        }
+}
+
+/// Accept a finished cell's ledger; return time spent on output.
+///
+/// Indexing: 'ordinal' counts only cells included in the composite,
+/// yet names are taken from the census cell it indexes, as
+/// run_census_in_parallel::operator() has always done.
+///
+/// The meter is used only to pause between printouts.
+
+double retired_cell_ledgers::add
+    (int                             ordinal
+    ,std::shared_ptr<Ledger const>   ledger
+    ,progress_meter                & meter
+    )
+{
+    LMI_ASSERT(next_ <= ordinal);
+    LMI_ASSERT(!contains(in_memory_, ordinal) && !contains(on_disk_, ordinal));
+    if(ordinal != next_ && memory_limit_ <= in_memory_.size())
+        {
+        fs::path const spill = spill_filepath(ordinal);
+        fs::ofstream ofs(spill, ios_out_trunc_binary());
+        on_disk_[ordinal] = spill;
+        ledger->write_binary(ofs);
+        }
+    else
+        {
+        in_memory_[ordinal] = ledger;
+        }
+    return flush(meter);
+}
+
+fs::path retired_cell_ledgers::cell_filepath(int ordinal) const
+{
+    return serial_file_path(file_, insured_name_(ordinal), ordinal, "hastur");
+}
+
+fs::path retired_cell_ledgers::spill_filepath(int ordinal) const
+{
+    std::string const name("lmi_census_cell_" + value_cast<std::string>(ordinal));
+    return unique_filepath(spill_directory() / name, ".spilled.ledger");
+}
+
+/// Composite and emit every ledger whose predecessors are all done.
+
+double retired_cell_ledgers::flush(progress_meter& meter)
+{
+    double seconds_for_output = 0.0;
+    for(;;)
+        {
+        std::shared_ptr<Ledger const> ledger;
+        auto const m = in_memory_.find(next_);
+        auto const d = on_disk_.find(next_);
+        if(in_memory_.end() != m)
+            {
+            ledger = m->second;
+            in_memory_.erase(m);
+            }
+        else if(on_disk_.end() != d)
+            {
+            std::shared_ptr<Ledger> z(new Ledger(1, mce_ill_reg, false, false, false));
+            {
+            fs::ifstream ifs(d->second, ios_in_binary());
+            z->read_binary(ifs, d->second.string());
+            }
+            fs::remove(d->second);
+            on_disk_.erase(d);
+            ledger = z;
+            }
+        else
+            {
+            break;
+            }
+        composite_.PlusEq(*ledger);
+        seconds_for_output += emitter_.emit_cell(cell_filepath(next_), *ledger);
+        meter.dawdle(pause_);
+        ++next_;
+        }
+    return seconds_for_output;
+}
+
+/// Values of earlier bases, set aside while later bases are run.
+///
+/// In low-memory mode, as soon as a basis has been run for every cell
+/// of a month-by-month census, each cell's values for that basis are
+/// written to a single temporary file in binary format and freed.
+/// Thus, each cell holds the values of only one basis at a time. They
+/// are read back just before the cell is finalized for all bases. The
+/// file is removed upon destruction (e.g., after cancellation).
+
+class spilled_variants final
+{
+  public:
+    spilled_variants();
+    ~spilled_variants();
+
+    void spill(int ordinal, Ledger&, mcenum_run_basis);
+    void restore(int ordinal, Ledger&);
+
+  private:
+    spilled_variants(spilled_variants const&) = delete;
+    spilled_variants& operator=(spilled_variants const&) = delete;
+
+    fs::path     const path_;
+    fs::fstream        file_;
+    std::map<int,std::vector<std::streamoff>> offsets_;
+};
+
+spilled_variants::spilled_variants()
+    :path_ (unique_filepath(spill_directory() / "lmi_census_values", ".spilled"))
+    ,file_ (path_, ios_in_out_trunc_binary())
+{
+    if(!file_)
+        {
+        alarum()
+            << "Unable to open temporary file '"
+            << path_.string()
+            << "'."
+            << LMI_FLUSH
+            ;
+        }
+}
+
+spilled_variants::~spilled_variants()
+{
+    try
+        {
+        file_.close();
+        fs::remove(path_);
+        }
+    catch(...)
+        {
+        // A leftover temporary file is harmless.
+        }
+}
+
+/// Write one cell's values for the given basis, and free them.
+///
+/// Indexing: 'ordinal' counts only cells included in the composite.
+
+void spilled_variants::spill(int ordinal, Ledger& ledger, mcenum_run_basis b)
+{
+    // The ledger may have been restricted to fewer bases than were
+    // run; see Ledger::RestrictRunBases().
+    if(!contains(ledger.GetRunBases(), b))
+        {
+        return;
+        }
+    file_.seekp(0, std::ios_base::end);
+    offsets_[ordinal].push_back(file_.tellp());
+    ledger.write_binary_variant(file_, b);
+    ledger.ReleaseOneLedgerVariant(b);
+}
+
+/// Read back every basis's values that were spilled for one cell.
+
+void spilled_variants::restore(int ordinal, Ledger& ledger)
+{
+    auto const i = offsets_.find(ordinal);
+    if(offsets_.end() == i)
+        {
+        return;
+        }
+    for(auto const& offset : i->second)
+        {
+        file_.seekg(offset);
+        ledger.read_binary_variant(file_, path_.string());
+        }
+    offsets_.erase(i);
+}
 } // Unnamed namespace.
 
 // Functors run_census_in_series and run_census_in_parallel exist as
@@ -89,10 +443,11 @@ progress_meter::enum_display_mode progress_meter_mode(mcenum_emission emission)
 class run_census_in_series
 {
   public:
+    template<typename Census>
     census_run_result operator()
         (fs::path           const& file
         ,mcenum_emission           emission
-        ,std::vector<Input> const& cells
+        ,Census             const& cells
         ,Ledger                  & composite
         );
 };
@@ -100,18 +455,35 @@ class run_census_in_series
 class run_census_in_parallel
 {
   public:
+    template<typename Census>
     census_run_result operator()
         (fs::path           const& file
         ,mcenum_emission           emission
-        ,std::vector<Input> const& cells
+        ,Census             const& cells
         ,Ledger                  & composite
         );
 };
 
+/// Calculate each cell, handing its ledger off for emission.
+///
+/// If the program permits it, emission is performed on another thread
+/// by class asynchronous_ledger_emitter, so that calculation of one
+/// cell overlaps output of its predecessors. The calculation time
+/// reported is then the elapsed time less only the time this thread
+/// spent waiting for output, while the output time reported is the
+/// time actually spent emitting, some of which overlaps calculation.
+/// Otherwise (e.g., in the GUI, whose output functions must be called
+/// on the main thread), each cell is emitted as soon as it has been
+/// calculated, on this thread.
+///
+/// When a pause between printouts is wanted, each cell's output is
+/// awaited before pausing, so that the pause has its intended effect.
+
+template<typename Census>
 census_run_result run_census_in_series::operator()
     (fs::path           const& file
     ,mcenum_emission    const  emission
-    ,std::vector<Input> const& cells
+    ,Census             const& cells
     ,Ledger                  & composite
     )
 {
@@ -119,47 +491,88 @@ census_run_result run_census_in_series::operator()
     census_run_result result;
     std::shared_ptr<progress_meter> meter
         (create_progress_meter
-            (cells.size()
+            (number_of_cells(cells)
             ,"Calculating all cells"
             ,progress_meter_mode(emission)
             )
         );
 
+    int const pause = intermission_between_printouts(emission);
+    double seconds_waiting_for_output = 0.0;
+
     ledger_emitter emitter(file, emission);
-    result.seconds_for_output_ += emitter.initiate();
+    double const seconds_to_initiate = emitter.initiate();
+    result.seconds_for_output_ += seconds_to_initiate;
+    seconds_waiting_for_output += seconds_to_initiate;
+
+    std::unique_ptr<asynchronous_ledger_emitter> pipeline;
+    if(asynchronous_emission_permitted())
+        {
+        pipeline.reset
+            (new asynchronous_ledger_emitter(emitter, pending_ledgers_limit)
+            );
+        }
 
-    for(unsigned int j = 0; j < cells.size(); ++j)
+    for(int j = 0; j < number_of_cells(cells); ++j)
         {
-        if(!cell_should_be_ignored(cells[j]))
+        if(!cell_should_be_ignored(cells, j))
             {
-            std::string const name(cells[j]["InsuredName"].str());
-            IllusVal IV(serial_file_path(file, name, j, "hastur").string());
-            IV.run(cells[j]);
+            std::string const name(cell_field(cells, j, "InsuredName"));
+            fs::path const cell_filepath(serial_file_path(file, name, j, "hastur"));
+            IllusVal IV(cell_filepath.string());
+            IV.run(cell_input(cells, j), emission);
             composite.PlusEq(*IV.ledger());
-            result.seconds_for_output_ += emitter.emit_cell
-                (serial_file_path(file, name, j, "hastur")
-                ,*IV.ledger()
-                );
-            meter->dawdle(intermission_between_printouts(emission));
+            if(pipeline)
+                {
+                seconds_waiting_for_output += pipeline->emit_cell
+                    (cell_filepath
+                    ,IV.ledger()
+                    );
+                if(0 != pause)
+                    {
+                    seconds_waiting_for_output += pipeline->wait();
+                    }
+                }
+            else
+                {
+                double const seconds = emitter.emit_cell
+                    (cell_filepath
+                    ,*IV.ledger()
+                    );
+                result.seconds_for_output_ += seconds;
+                seconds_waiting_for_output += seconds;
+                }
+            meter->dawdle(pause);
             }
         if(!meter->reflect_progress())
             {
             result.completed_normally_ = false;
-            goto done;
+            break;
             }
         }
-    meter->culminate();
-
-    result.seconds_for_output_ += emitter.emit_cell
-        (serial_file_path(file, "composite", -1, "hastur")
-        ,composite
-        );
-    result.seconds_for_output_ += emitter.finish();
+    if(pipeline)
+        {
+        seconds_waiting_for_output += pipeline->wait();
+        result.seconds_for_output_ += pipeline->seconds_for_output();
+        pipeline.reset();
+        }
+    if(result.completed_normally_)
+        {
+        meter->culminate();
+        double const seconds_for_composite =
+              emitter.emit_cell
+                (serial_file_path(file, "composite", -1, "hastur")
+                ,composite
+                )
+            + emitter.finish()
+            ;
+        result.seconds_for_output_ += seconds_for_composite;
+        seconds_waiting_for_output += seconds_for_composite;
+        }
 
-  done:
     double total_seconds = timer.stop().elapsed_seconds();
     status() << Timer::elapsed_msec_str(total_seconds) << std::flush;
-    result.seconds_for_calculations_ = total_seconds - result.seconds_for_output_;
+    result.seconds_for_calculations_ = total_seconds - seconds_waiting_for_output;
     return result;
 }
 
@@ -231,10 +644,11 @@ census_run_result run_census_in_series::operator()
 /// EOY DB reflects EOY AV: thus, they're the values normally printed
 /// on an illustration.
 
+template<typename Census>
 census_run_result run_census_in_parallel::operator()
     (fs::path           const& file
     ,mcenum_emission    const  emission
-    ,std::vector<Input> const& cells
+    ,Census             const& cells
     ,Ledger                  & composite
     )
 {
@@ -242,37 +656,58 @@ census_run_result run_census_in_parallel::operator()
     census_run_result result;
     std::shared_ptr<progress_meter> meter
         (create_progress_meter
-            (cells.size()
+            (number_of_cells(cells)
             ,"Initializing all cells"
             ,progress_meter_mode(emission)
             )
         );
 
     ledger_emitter emitter(file, emission);
+    retired_cell_ledgers retired
+        (composite
+        ,emitter
+        ,file
+        ,[&cells] (int j) {return cell_field(cells, j, "InsuredName");}
+        ,retained_ledgers_limit
+        ,intermission_between_printouts(emission)
+        );
+    bool const low_memory = mce_emit_low_memory & emission;
+    std::unique_ptr<spilled_variants> spilled;
+    if(low_memory)
+        {
+        spilled.reset(new spilled_variants);
+        }
 
+    // Cells still being calculated, and their ordinals among cells
+    // included in the composite. A cell is removed from both when it
+    // has been retired.
     std::vector<std::shared_ptr<AccountValue>> cell_values;
+    std::vector<int> cell_ordinals;
+    std::shared_ptr<yare_input const> case_input;
+    int number_of_included_cells = 0;
     std::vector<mcenum_run_basis> const& RunBases = composite.GetRunBases();
 
-    int const first_cell_inforce_year  = value_cast<int>((*cells.begin())["InforceYear"].str());
-    int const first_cell_inforce_month = value_cast<int>((*cells.begin())["InforceMonth"].str());
-    cell_values.reserve(cells.size());
-    int j = 0;
-    for(auto const& ip : cells)
+    int const first_cell_inforce_year  = value_cast<int>(cell_field(cells, 0, "InforceYear"));
+    int const first_cell_inforce_month = value_cast<int>(cell_field(cells, 0, "InforceMonth"));
+    cell_values.reserve(number_of_cells(cells));
+    for(int j = 0; j < number_of_cells(cells); ++j)
         {
         // This condition need be written only once, here, because
         // subsequently 'cell_values' (which reflects the condition)
         // is iterated across instead of 'cells'.
-        if(!cell_should_be_ignored(cells[j]))
+        if(!cell_should_be_ignored(cells, j))
             {
             { // Begin fenv_guard scope.
             fenv_guard fg;
-            std::shared_ptr<AccountValue> av(new AccountValue(ip));
-            std::string const name(cells[j]["InsuredName"].str());
+            std::shared_ptr<AccountValue> av(new AccountValue(cell_input(cells, j)));
+            std::string const name(cell_field(cells, j, "InsuredName"));
             // Indexing: here, j is an index into cells, not cell_values.
             av->SetDebugFilename
                 (serial_file_path(file, name, j, "hastur").string()
                 );
+            av->RestrictRunBases(run_bases_required(emission));
 
+            cell_ordinals.push_back(static_cast<int>(cell_values.size()));
             cell_values.push_back(av);
 
             if(contains(av->yare_input_.Comments, "idiosyncrasyZ"))
@@ -308,21 +743,30 @@ census_run_result run_census_in_parallel::operator()
             result.completed_normally_ = false;
             goto done;
             }
-
-        ++j;
         } // End for.
     meter->culminate();
     if(cell_values.empty())
         {
-        // Make sure it's safe to dereference cell_values[0] later.
+        // Make sure it's safe to dereference cell_values[0] below.
         alarum()
             << "No cell with any lives was included in the composite."
             << LMI_FLUSH
             ;
         }
+    number_of_included_cells = static_cast<int>(cell_values.size());
+    // Case-level input parameters are taken from the first cell. They
+    // are copied because that cell may be retired before the last
+    // basis has been run.
+    case_input.reset(new yare_input(cell_values[0]->yare_input_));
+
+    result.seconds_for_output_ += emitter.initiate();
 
     for(auto const& run_basis : RunBases)
         {
+        // Cells are retired only while the last basis is run, because
+        // until then they still have bases to calculate.
+        bool const is_last_basis = run_basis == RunBases.back();
+
         // It seems somewhat anomalous to create and update a GUI
         // progress meter inside this critical calculation section,
         // because it is not entirely inconceivable that doing so
@@ -357,16 +801,20 @@ census_run_result run_census_in_parallel::operator()
 
         // Variables to support tiering and experience rating.
 
+        // These case-level parameters are set when each basis is
+        // initialized, so they're taken from the first cell, which
+        // cannot be retired until after the last basis's start.
+        LMI_ASSERT(!cell_values.empty() && 0 == cell_ordinals.front());
         double const case_ibnr_months =
-            cell_values[0]->ibnr_as_months_of_mortality_charges()
+            cell_values.front()->ibnr_as_months_of_mortality_charges()
             ;
         double const case_experience_rating_amortization_years =
-            cell_values[0]->experience_rating_amortization_years()
+            cell_values.front()->experience_rating_amortization_years()
             ;
 
         double case_accum_net_mortchgs = 0.0;
         double case_accum_net_claims   = 0.0;
-        double case_k_factor = cell_values[0]->yare_input_.ExperienceRatingInitialKFactor;
+        double case_k_factor = case_input->ExperienceRatingInitialKFactor;
 
         // Experience rating as implemented here uses either a special
         // scalar input rate, or the separate-account rate. Those
@@ -376,16 +824,16 @@ census_run_result run_census_in_parallel::operator()
 
         std::vector<double> experience_reserve_rate;
         std::copy
-            (cell_values[0]->yare_input_.SeparateAccountRate.begin()
-            ,cell_values[0]->yare_input_.SeparateAccountRate.end()
+            (case_input->SeparateAccountRate.begin()
+            ,case_input->SeparateAccountRate.end()
             ,std::back_inserter(experience_reserve_rate)
             );
         experience_reserve_rate.resize(MaxYr, experience_reserve_rate.back());
-        if(cell_values[0]->yare_input_.OverrideExperienceReserveRate)
+        if(case_input->OverrideExperienceReserveRate)
             {
             experience_reserve_rate.assign
                 (experience_reserve_rate.size()
-                ,cell_values[0]->yare_input_.ExperienceReserveRate
+                ,case_input->ExperienceReserveRate
                 );
             }
 
@@ -507,7 +955,7 @@ census_run_result run_census_in_parallel::operator()
 
             if(first_cell_inforce_year == year)
                 {
-                case_accum_net_mortchgs += cell_values[0]->yare_input_.InforceNetExperienceReserve;
+                case_accum_net_mortchgs += case_input->InforceNetExperienceReserve;
                 }
 
             // Apportion experience-rating reserve uniformly across
@@ -520,14 +968,14 @@ census_run_result run_census_in_parallel::operator()
             // equal the original total reserve.
 
             if
-                (   cell_values[0]->yare_input_.UseExperienceRating
+                (   case_input->UseExperienceRating
                 &&  mce_gen_curr == expense_and_general_account_basis
                 &&  0.0 != eoy_inforce_lives
                 )
                 {
                 if(first_cell_inforce_year == year)
                     {
-                    years_net_mortchgs += cell_values[0]->yare_input_.InforceYtdNetCoiCharge;
+                    years_net_mortchgs += case_input->InforceYtdNetCoiCharge;
                     }
                 double case_ibnr =
                         years_net_mortchgs
@@ -590,6 +1038,48 @@ census_run_result run_census_in_parallel::operator()
                     }
                 }
 
+            // In low-memory mode, retire each cell that has lapsed or
+            // matured: it cannot change in any later year, and no
+            // cell's values depend on it after this year's experience
+            // rating. Finalize it now, and let 'retired' composite and
+            // emit its ledger (in census order), so that its memory
+            // can be freed.
+            //
+            // Every cell must be held throughout each earlier basis,
+            // and at the start of the last: experience rating couples
+            // all cells in force, and a later basis reuses values set
+            // on the first (e.g., payments determined by strategies).
+            // Peak memory therefore still grows with the number of
+            // cells in force, but not with the number of bases.
+
+            if(low_memory && is_last_basis)
+                {
+                std::size_t k = 0;
+                for(std::size_t c = 0; c < cell_values.size(); ++c)
+                    {
+                    AccountValue& i = *cell_values[c];
+                    if(i.ItLapsed || i.GetLength() <= 1 + year)
+                        {
+                        i.FinalizeLife(run_basis);
+                        spilled->restore(cell_ordinals[c], *i.ledger_);
+                        i.FinalizeLifeAllBases();
+                        result.seconds_for_output_ += retired.add
+                            (cell_ordinals[c]
+                            ,i.ledger_from_av()
+                            ,*meter
+                            );
+                        }
+                    else
+                        {
+                        cell_values  [k] = cell_values  [c];
+                        cell_ordinals[k] = cell_ordinals[c];
+                        ++k;
+                        }
+                    }
+                cell_values  .resize(k);
+                cell_ordinals.resize(k);
+                }
+
             if(!meter->reflect_progress())
                 {
                 result.completed_normally_ = false;
@@ -598,57 +1088,49 @@ census_run_result run_census_in_parallel::operator()
             } // End for year.
         meter->culminate();
 
-        for(auto& i : cell_values)
+        for(std::size_t c = 0; c < cell_values.size(); ++c)
             {
-            i->FinalizeLife(run_basis);
+            AccountValue& i = *cell_values[c];
+            i.FinalizeLife(run_basis);
+            // Values for the last basis are used at once, so spilling
+            // them would be pointless.
+            if(low_memory && !is_last_basis)
+                {
+                spilled->spill(cell_ordinals[c], *i.ledger_, run_basis);
+                }
             }
 
         } // End fenv_guard scope.
         } // End for.
 
+    // Any cells not yet retired remain in force through the last year.
     meter = create_progress_meter
         (cell_values.size()
         ,"Finalizing all cells"
         ,progress_meter_mode(emission)
         );
-    for(auto& i : cell_values)
+    for(std::size_t c = 0; c < cell_values.size(); ++c)
         {
         fenv_guard fg;
-        i->FinalizeLifeAllBases();
-        composite.PlusEq(*i->ledger_from_av());
-        if(!meter->reflect_progress())
+        if(low_memory)
             {
-            result.completed_normally_ = false;
-            goto done;
+            spilled->restore(cell_ordinals[c], *cell_values[c]->ledger_);
             }
-        }
-    meter->culminate();
-
-    result.seconds_for_output_ += emitter.initiate();
-
-    meter = create_progress_meter
-        (cell_values.size()
-        ,"Writing output for all cells"
-        ,progress_meter_mode(emission)
-        );
-    j = 0;
-    for(auto const& i : cell_values)
-        {
-        // Indexing: here, j is an index into cell_values, not cells.
-        std::string const name(cells[j]["InsuredName"].str());
-        result.seconds_for_output_ += emitter.emit_cell
-            (serial_file_path(file, name, j, "hastur")
-            ,*i->ledger_from_av()
+        cell_values[c]->FinalizeLifeAllBases();
+        result.seconds_for_output_ += retired.add
+            (cell_ordinals[c]
+            ,cell_values[c]->ledger_from_av()
+            ,*meter
             );
-        meter->dawdle(intermission_between_printouts(emission));
+        cell_values[c].reset();
         if(!meter->reflect_progress())
             {
             result.completed_normally_ = false;
             goto done;
             }
-        ++j;
         }
     meter->culminate();
+    LMI_ASSERT(number_of_included_cells == retired.next());
 
     result.seconds_for_output_ += emitter.emit_cell
         (serial_file_path(file, "composite", -1, "hastur")
@@ -668,33 +1150,68 @@ census_run_result run_census::operator()
     ,mcenum_emission    const  emission
     ,std::vector<Input> const& cells
     )
+{
+    return run(file, emission, cells);
+}
+
+/// Run all cells in a sparsely-stored census.
+///
+/// Each cell is materialized only when it's needed, and discarded
+/// soon afterward, so a std::vector<Input> of all cells is never held
+/// in memory. That's the whole saving when cells are run life by
+/// life. A census run month by month calculates all cells together,
+/// and the AccountValue objects it creates for them, rather than
+/// their Input objects, dominate the memory it uses.
+
+census_run_result run_census::operator()
+    (fs::path           const& file
+    ,mcenum_emission    const  emission
+    ,delta_census       const& cells
+    )
+{
+    return run(file, emission, cells);
+}
+
+template<typename Census>
+census_run_result run_census::run
+    (fs::path           const& file
+    ,mcenum_emission    const  emission
+    ,Census             const& cells
+    )
 {
     census_run_result result;
 
     int composite_length = 0;
-    for(auto const& i : cells)
+    for(int j = 0; j < number_of_cells(cells); ++j)
         {
-        if(!cell_should_be_ignored(i))
+        if(!cell_should_be_ignored(cells, j))
             {
-            composite_length = std::max(composite_length, i.years_to_maturity());
+            composite_length = std::max
+                (composite_length
+                ,cell_input(cells, j).years_to_maturity()
+                );
             }
         }
     // If cell_should_be_ignored() is true for all cells, composite
     // length is appropriately zero.
+    Input const& first_cell = cell_input(cells, 0);
     composite_.reset
         (new Ledger
             (composite_length
-            ,cells[0].ledger_type()
+            ,first_cell.ledger_type()
             ,false
             ,false
             ,true
             )
         );
+    // Cells calculate only the bases that emission requires, so the
+    // composite must have only those bases, too.
+    composite_->RestrictRunBases(run_bases_required(emission));
 
     // Use the first cell's run order for the entire census, ignoring
     // any conflicting run order for any other cell--which would have
     // been prevented upstream by assert_consistent_run_order().
-    mcenum_run_order order = yare_input(cells[0]).RunOrder;
+    mcenum_run_order order = yare_input(first_cell).RunOrder;
     switch(order)
         {
         case mce_life_by_life:
@@ -34,6 +34,7 @@
 
 class Input;
 class Ledger;
+class delta_census;
 
 /// Result of running a census.
 ///
@@ -83,9 +84,22 @@ class LMI_SO run_census final
         ,std::vector<Input> const& cells
         );
 
+    census_run_result operator()
+        (fs::path           const& file
+        ,mcenum_emission           emission
+        ,delta_census       const& cells
+        );
+
     std::shared_ptr<Ledger const> composite() const;
 
   private:
+    template<typename Census>
+    census_run_result run
+        (fs::path           const& file
+        ,mcenum_emission           emission
+        ,Census             const& cells
+        );
+
     std::shared_ptr<Ledger> composite_;
 };
 
@@ -0,0 +1,336 @@
+// Read and write gzip-compressed data through standard streams.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "gzip_stream.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+
+#include <zlib.h>
+
+#include <istream>
+#include <memory>                       // std::unique_ptr
+#include <streambuf>
+
+namespace
+{
+/// Size of each buffer passed to zlib.
+
+std::size_t const chunk_size = 65536;
+
+/// Window-bits argument that makes zlib read and write gzip format,
+/// rather than its own.
+
+int const gzip_window_bits = 16 + MAX_WBITS;
+
+/// Release an inflation stream however its scope is left.
+
+class inflater final
+{
+  public:
+    inflater()
+        {
+        z_.zalloc = Z_NULL;
+        z_.zfree  = Z_NULL;
+        z_.opaque = Z_NULL;
+        z_.next_in  = Z_NULL;
+        z_.avail_in = 0;
+        if(Z_OK != inflateInit2(&z_, gzip_window_bits))
+            {
+            alarum() << "Unable to initialize decompression." << LMI_FLUSH;
+            }
+        }
+    ~inflater() {inflateEnd(&z_);}
+
+    z_stream& z() {return z_;}
+
+  private:
+    inflater(inflater const&) = delete;
+    inflater& operator=(inflater const&) = delete;
+
+    z_stream z_;
+};
+} // Unnamed namespace.
+
+/// Determine whether a stream holds gzip-compressed data.
+///
+/// Only the first byte is examined, and it isn't extracted. That
+/// suffices to tell gzip from xml: the first byte of gzip's magic
+/// number, 0x1F, can't begin an xml document--indeed, xml forbids
+/// that character everywhere.
+
+bool is_gzip_compressed(std::istream const& is)
+{
+    return 0x1f == is.rdbuf()->sgetc();
+}
+
+/// Determine whether a file name's extension is '.gz'.
+
+bool has_gzip_extension(std::string const& filename)
+{
+    std::string const extension(".gz");
+    return
+            extension.size() < filename.size()
+        &&  0 == filename.compare
+                (filename.size() - extension.size()
+                ,extension.size()
+                ,extension
+                )
+        ;
+}
+
+/// Decompress gzip data, passing each decompressed piece to 'sink'
+/// as soon as it's available, so that a parser can consume a large
+/// file without its decompressed contents ever being held in memory.
+///
+/// Several concatenated gzip members are read as one, as gzip(1)
+/// reads them. Throws if the data are invalid or truncated.
+
+void gunzip(std::istream const& is, gunzip_sink const& sink)
+{
+    std::streambuf& source = *is.rdbuf();
+    std::unique_ptr<char[]> const in (new char[chunk_size]);
+    std::unique_ptr<char[]> const out(new char[chunk_size]);
+    inflater decompressor;
+    z_stream& z = decompressor.z();
+    int rc = Z_OK;
+    for(;;)
+        {
+        if(0 == z.avail_in)
+            {
+            std::streamsize const n = source.sgetn
+                (in.get()
+                ,static_cast<std::streamsize>(chunk_size)
+                );
+            if(0 == n)
+                {
+                break;
+                }
+            z.next_in  = reinterpret_cast<Bytef*>(in.get());
+            z.avail_in = static_cast<uInt>(n);
+            }
+        if(Z_STREAM_END == rc)
+            {
+            // Another member follows.
+            inflateReset(&z);
+            }
+        z.next_out  = reinterpret_cast<Bytef*>(out.get());
+        z.avail_out = static_cast<uInt>(chunk_size);
+        rc = inflate(&z, Z_NO_FLUSH);
+        if(Z_OK != rc && Z_STREAM_END != rc)
+            {
+            alarum()
+                << "Invalid compressed data: "
+                << (z.msg ? z.msg : "unknown error")
+                << "."
+                << LMI_FLUSH
+                ;
+            }
+        std::size_t const produced = chunk_size - z.avail_out;
+        if(0 != produced && !sink(out.get(), produced))
+            {
+            return;
+            }
+        }
+    if(Z_STREAM_END != rc)
+        {
+        alarum() << "Compressed data are truncated." << LMI_FLUSH;
+        }
+}
+
+/// Decompress gzip data into a string.
+
+std::string gunzip(std::istream const& is)
+{
+    std::string z;
+    gunzip
+        (is
+        ,[&z] (char const* data, std::size_t length)
+            {
+            z.append(data, length);
+            return true;
+            }
+        );
+    return z;
+}
+
+/// Stream buffer that compresses its output into another one.
+///
+/// A streambuf mustn't throw, so failure is remembered, and reported
+/// by finish().
+
+class gzip_ostreambuf final
+    :public std::streambuf
+{
+  public:
+    explicit gzip_ostreambuf(std::streambuf& sink);
+    ~gzip_ostreambuf() override;
+
+    void finish();
+
+  private:
+    gzip_ostreambuf(gzip_ostreambuf const&) = delete;
+    gzip_ostreambuf& operator=(gzip_ostreambuf const&) = delete;
+
+    // std::streambuf overrides.
+    int_type overflow(int_type c) override;
+    int sync() override;
+
+    void compress(int flush);
+
+    std::streambuf&         sink_;
+    z_stream                z_;
+    bool                    finished_;
+    bool                    failed_;
+    std::unique_ptr<char[]> in_;
+    std::unique_ptr<char[]> out_;
+};
+
+gzip_ostreambuf::gzip_ostreambuf(std::streambuf& sink)
+    :sink_     (sink)
+    ,finished_ (false)
+    ,failed_   (false)
+    ,in_       (new char[chunk_size])
+    ,out_      (new char[chunk_size])
+{
+    z_.zalloc = Z_NULL;
+    z_.zfree  = Z_NULL;
+    z_.opaque = Z_NULL;
+    int const rc = deflateInit2
+        (&z_
+        ,Z_DEFAULT_COMPRESSION
+        ,Z_DEFLATED
+        ,gzip_window_bits
+        ,8 // Default memory level.
+        ,Z_DEFAULT_STRATEGY
+        );
+    if(Z_OK != rc)
+        {
+        alarum() << "Unable to initialize compression." << LMI_FLUSH;
+        }
+    setp(in_.get(), in_.get() + chunk_size);
+}
+
+gzip_ostreambuf::~gzip_ostreambuf()
+{
+    if(!finished_)
+        {
+        compress(Z_FINISH);
+        }
+    deflateEnd(&z_);
+}
+
+/// Write everything that remains, and report any failure.
+
+void gzip_ostreambuf::finish()
+{
+    if(!finished_)
+        {
+        compress(Z_FINISH);
+        finished_ = true;
+        }
+    if(failed_)
+        {
+        alarum() << "Unable to write compressed data." << LMI_FLUSH;
+        }
+}
+
+gzip_ostreambuf::int_type gzip_ostreambuf::overflow(int_type c)
+{
+    if(finished_)
+        {
+        return traits_type::eof();
+        }
+    compress(Z_NO_FLUSH);
+    if(failed_)
+        {
+        return traits_type::eof();
+        }
+    if(!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        }
+    return traits_type::not_eof(c);
+}
+
+/// Compress what's buffered. Compressed data are flushed only by
+/// finish(): flushing them sooner would worsen compression.
+
+int gzip_ostreambuf::sync()
+{
+    if(finished_)
+        {
+        return failed_ ? -1 : 0;
+        }
+    compress(Z_NO_FLUSH);
+    return failed_ ? -1 : 0;
+}
+
+/// Compress the put area's contents, writing whatever zlib produces.
+
+void gzip_ostreambuf::compress(int flush)
+{
+    LMI_ASSERT(!finished_);
+    z_.next_in  = reinterpret_cast<Bytef*>(pbase());
+    z_.avail_in = static_cast<uInt>(pptr() - pbase());
+    do
+        {
+        z_.next_out  = reinterpret_cast<Bytef*>(out_.get());
+        z_.avail_out = static_cast<uInt>(chunk_size);
+        if(Z_STREAM_ERROR == deflate(&z_, flush))
+            {
+            failed_ = true;
+            break;
+            }
+        std::streamsize const n = static_cast<std::streamsize>
+            (chunk_size - z_.avail_out
+            );
+        if(n != sink_.sputn(out_.get(), n))
+            {
+            failed_ = true;
+            break;
+            }
+        }
+    while(0 == z_.avail_out);
+    setp(in_.get(), in_.get() + chunk_size);
+}
+
+gzip_ostream::gzip_ostream(std::ostream& sink)
+    :std::ostream(nullptr)
+    ,buffer_(new gzip_ostreambuf(*sink.rdbuf()))
+{
+    rdbuf(buffer_.get());
+}
+
+gzip_ostream::~gzip_ostream() = default;
+
+void gzip_ostream::finish()
+{
+    flush();
+    buffer_->finish();
+    if(!*this)
+        {
+        alarum() << "Unable to write compressed data." << LMI_FLUSH;
+        }
+}
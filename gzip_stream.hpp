@@ -0,0 +1,72 @@
+// Read and write gzip-compressed data through standard streams.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef gzip_stream_hpp
+#define gzip_stream_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <cstddef>                      // std::size_t
+#include <functional>
+#include <iosfwd>
+#include <memory>                       // std::unique_ptr
+#include <ostream>
+#include <string>
+
+class gzip_ostreambuf;
+
+/// Receives each piece of decompressed data; returns false to stop.
+
+typedef std::function<bool(char const*, std::size_t)> gunzip_sink;
+
+bool LMI_SO is_gzip_compressed(std::istream const&);
+
+bool LMI_SO has_gzip_extension(std::string const& filename);
+
+void LMI_SO gunzip(std::istream const&, gunzip_sink const&);
+
+std::string LMI_SO gunzip(std::istream const&);
+
+/// Output stream that writes gzip-compressed data to another stream.
+///
+/// Call finish() after writing everything: it writes whatever the
+/// compressor still holds, and throws if anything could not be
+/// written. The destructor finishes too, but must ignore failure.
+
+class LMI_SO gzip_ostream final
+    :public std::ostream
+{
+  public:
+    explicit gzip_ostream(std::ostream& sink);
+    ~gzip_ostream() override;
+
+    void finish();
+
+  private:
+    gzip_ostream(gzip_ostream const&) = delete;
+    gzip_ostream& operator=(gzip_ostream const&) = delete;
+
+    std::unique_ptr<gzip_ostreambuf> buffer_;
+};
+
+#endif // gzip_stream_hpp
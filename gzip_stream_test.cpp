@@ -0,0 +1,190 @@
+// Read and write gzip-compressed data through standard streams--unit test.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "gzip_stream.hpp"
+
+#include "test_tools.hpp"
+#include "timer.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+/// Compress a string as a file would be compressed.
+
+std::string compressed(std::string const& s)
+{
+    std::ostringstream oss;
+    gzip_ostream gz(oss);
+    gz << s;
+    gz.finish();
+    return oss.str();
+}
+
+/// Text resembling a census: long, and very repetitive.
+
+std::string const& census_like_text()
+{
+    static std::string z;
+    if(z.empty())
+        {
+        z = "<?xml version=\"1.0\"?>\n<multiple_cell_document>\n";
+        for(int j = 0; j < 10000; ++j)
+            {
+            z += "<cell><IssueAge>";
+            z += std::to_string(20 + j % 50);
+            z += "</IssueAge><SpecifiedAmount>1000000</SpecifiedAmount></cell>\n";
+            }
+        z += "</multiple_cell_document>\n";
+        }
+    return z;
+}
+
+std::string const& compressed_census_like_text()
+{
+    static std::string const z(compressed(census_like_text()));
+    return z;
+}
+
+void mete_gzip()
+{
+    compressed(census_like_text());
+}
+
+void mete_gunzip()
+{
+    std::istringstream iss(compressed_census_like_text());
+    gunzip(iss);
+}
+} // Unnamed namespace.
+
+void test_round_trip()
+{
+    std::string const& s = census_like_text();
+    std::string const z = compressed(s);
+    // Compression should be substantial for such repetitive text.
+    BOOST_TEST(z.size() < s.size() / 10);
+
+    std::istringstream iss(z);
+    BOOST_TEST(is_gzip_compressed(iss));
+    // Examining the stream doesn't extract anything.
+    BOOST_TEST(is_gzip_compressed(iss));
+    BOOST_TEST_EQUAL(s, gunzip(iss));
+
+    std::istringstream plain(s);
+    BOOST_TEST(!is_gzip_compressed(plain));
+
+    std::istringstream empty;
+    BOOST_TEST(!is_gzip_compressed(empty));
+    BOOST_TEST_EQUAL("", gunzip(std::istringstream(compressed(""))));
+}
+
+void test_streaming()
+{
+    std::string const& s = census_like_text();
+    std::istringstream iss(compressed(s));
+    std::string z;
+    int pieces = 0;
+    gunzip
+        (iss
+        ,[&] (char const* data, std::size_t length)
+            {
+            z.append(data, length);
+            ++pieces;
+            return true;
+            }
+        );
+    BOOST_TEST_EQUAL(s, z);
+    // Data are delivered in pieces, not all at once.
+    BOOST_TEST(1 < pieces);
+
+    // The sink can stop decompression early.
+    std::istringstream again(compressed(s));
+    std::size_t received = 0;
+    gunzip
+        (again
+        ,[&received] (char const*, std::size_t length)
+            {
+            received += length;
+            return false;
+            }
+        );
+    BOOST_TEST(0 < received);
+    BOOST_TEST(received < s.size());
+}
+
+void test_concatenated_members()
+{
+    std::istringstream iss(compressed("abc") + compressed("def"));
+    BOOST_TEST_EQUAL("abcdef", gunzip(iss));
+}
+
+void test_errors()
+{
+    std::string const z = compressed(census_like_text());
+
+    std::istringstream truncated(z.substr(0, z.size() / 2));
+    BOOST_TEST_THROW
+        (gunzip(truncated)
+        ,std::runtime_error
+        ,"Compressed data are truncated."
+        );
+
+    std::string corrupt(z);
+    corrupt[3] = '\xff'; // Reserved flag bits.
+    std::istringstream bad_header(corrupt);
+    BOOST_TEST_THROW
+        (gunzip(bad_header)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Invalid compressed data: ")
+        );
+}
+
+void test_extension()
+{
+    BOOST_TEST( has_gzip_extension("sample.cns.gz"));
+    BOOST_TEST(!has_gzip_extension("sample.cns"));
+    BOOST_TEST(!has_gzip_extension(".gz"));
+    BOOST_TEST(!has_gzip_extension("sample.gzip"));
+}
+
+void assay_speed()
+{
+    std::cout
+        << "  Speed tests...\n"
+        << "  compress   " << TimeAnAliquot(mete_gzip  ) << '\n'
+        << "  decompress " << TimeAnAliquot(mete_gunzip) << '\n'
+        ;
+}
+
+int test_main(int, char*[])
+{
+    test_round_trip();
+    test_streaming();
+    test_concatenated_members();
+    test_errors();
+    test_extension();
+    assay_speed();
+    return 0;
+}
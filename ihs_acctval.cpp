@@ -100,6 +100,47 @@ AccountValue::AccountValue(Input const& input)
     ,SepBasis_             (mce_sep_full)
     ,OldDBOpt              (mce_option1)
     ,YearsDBOpt            (mce_option1)
+{
+    SetInitialState();
+}
+
+/// Prepare to run again with revised input.
+///
+/// Sensitivity studies run one cell many times, varying only one
+/// input field. If BasicValues::IsRevisable() accepts that field,
+/// this object can be reused: only the few members of BasicValues
+/// that depend on the field are rebuilt, instead of reinitializing
+/// the product database, mortality rates, and 7702 and 7702A data.
+/// Everything else is restored to its newly-constructed state, so
+/// that running again gives the same results as running a newly-
+/// constructed object. Any restriction of run bases is forgotten,
+/// as is any ledger already obtained from ledger_from_av(), which
+/// is not modified.
+
+void AccountValue::ReviseInput(Input const& input)
+{
+    BasicValues::ReviseInput(yare_input(Input::consummate(input)));
+
+    Solving               = mce_solve_none != BasicValues::yare_input_.SolveType;
+    SolvingForGuarPremium = false;
+    ItLapsed              = false;
+    ledger_.reset(new Ledger(BasicValues::GetLength(), BasicValues::ledger_type(), BasicValues::nonillustrated(), BasicValues::no_can_issue(), false));
+    ledger_invariant_.reset(new LedgerInvariant(BasicValues::GetLength()));
+    ledger_variant_  .reset(new LedgerVariant  (BasicValues::GetLength()));
+    SolveGenBasis_        = mce_gen_curr;
+    SolveSepBasis_        = mce_sep_full;
+    RunBasis_             = mce_run_gen_curr_sep_full;
+    GenBasis_             = mce_gen_curr;
+    SepBasis_             = mce_sep_full;
+    OldDBOpt              = mce_option1;
+    YearsDBOpt            = mce_option1;
+
+    SetInitialState();
+}
+
+/// Initialize what the constructor's initializer-list doesn't.
+
+void AccountValue::SetInitialState()
 {
     // Explicitly initialize antediluvian members. It's generally
     // better to do this in the initializer-list, but here they can
@@ -139,7 +180,7 @@ AccountValue::AccountValue(Input const& input)
         (   InvariantValues().InforceLives.size()
         ==  static_cast<unsigned int>(1 + BasicValues::GetLength())
         );
-    partial_mortality_q.resize(BasicValues::GetLength());
+    partial_mortality_q.assign(BasicValues::GetLength(), 0.0);
     // TODO ?? 'InvariantValues().InforceLives' may be thought of as
     // counting potential inforce lives: it does not reflect lapses.
     // It should either reflect lapses or be renamed. Meanwhile,
@@ -164,13 +205,13 @@ AccountValue::AccountValue(Input const& input)
             );
         }
 
-    OverridingEePmts    .resize(12 * BasicValues::GetLength());
-    OverridingErPmts    .resize(12 * BasicValues::GetLength());
+    OverridingEePmts    .assign(12 * BasicValues::GetLength(), 0.0);
+    OverridingErPmts    .assign(12 * BasicValues::GetLength(), 0.0);
 
-    OverridingLoan      .resize(BasicValues::GetLength());
-    OverridingWD        .resize(BasicValues::GetLength());
+    OverridingLoan      .assign(BasicValues::GetLength(), 0.0);
+    OverridingWD        .assign(BasicValues::GetLength(), 0.0);
 
-    SurrChg_            .resize(BasicValues::GetLength());
+    SurrChg_            .assign(BasicValues::GetLength(), 0.0);
 
     YearlyTaxBasis      .reserve(BasicValues::GetLength());
     YearlyNoLapseActive .reserve(BasicValues::GetLength());
@@ -232,6 +273,15 @@ void AccountValue::SetGuarPrem()
     ledger_->SetGuarPremium(GuarPremium);
 }
 
+/// Calculate only the given run bases.
+///
+/// See Ledger::RestrictRunBases(). This must be called before RunAV().
+
+void AccountValue::RestrictRunBases(std::vector<mcenum_run_basis> const& wanted)
+{
+    ledger_->RestrictRunBases(wanted);
+}
+
 //============================================================================
 double AccountValue::RunOneBasis(mcenum_run_basis a_Basis)
 {
@@ -242,6 +242,34 @@ void BasicValues::Init()
     Init7702A();
 }
 
+/// Input fields that ReviseInput() can change.
+///
+/// Each affects only members that ReviseInput() rebuilds, which are
+/// cheap to initialize; fields that affect anything else, such as
+/// mortality rates or 7702 and 7702A data, require a new object.
+
+bool BasicValues::IsRevisable(std::string const& input_field)
+{
+    static std::vector<std::string> const revisable
+        {"CorporationPayment"
+        ,"GeneralAccountRate"
+        ,"Payment"
+        };
+    return contains(revisable, input_field);
+}
+
+/// Replace input with a revision that differs only in fields that
+/// IsRevisable() accepts, and rebuild only what depends on them.
+
+void BasicValues::ReviseInput(yare_input const& revised)
+{
+    LMI_ASSERT(revised.ProductName == yare_input_.ProductName);
+    LMI_ASSERT(revised.IssueAge    == yare_input_.IssueAge   );
+    yare_input_ = revised;
+    InterestRates_.reset(new InterestRates(*this));
+    Outlay_       .reset(new modal_outlay (yare_input_));
+}
+
 //============================================================================
 #include "ihs_x_type.hpp"               // x_product_rule_violated TAXATION !! remove later
 // TODO ??  Not for general use--use for GPT server only, for now. TAXATION !! refactor later
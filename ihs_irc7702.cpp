@@ -399,9 +399,6 @@ void Irc7702::Init()
     InitPvVectors(Opt1Int4Pct);
     InitPvVectors(Opt2Int4Pct);
     InitPvVectors(Opt1Int6Pct);
-    // TODO ?? We can delete the commutation functions here, rather than in
-    // the dtor, to save some space. We defer doing so until the
-    // program is complete. TAXATION !! It would be better not to use pointers--see header.
 }
 
 //============================================================================
@@ -436,37 +433,31 @@ void Irc7702::InitCommFns()
         }
 
     // Commutation functions using 4% min i: both options 1 and 2
-    CommFns[Opt1Int4Pct].reset
-        (new ULCommFns
-            (Qc
-            ,GLPic
-            ,glp_naar_disc_rate
-            ,mce_option1_for_7702
-            ,mce_monthly
-            )
+    CommFns[Opt1Int4Pct] = shared_ul_comm_fns
+        (Qc
+        ,GLPic
+        ,glp_naar_disc_rate
+        ,mce_option1_for_7702
+        ,mce_monthly
         );
     DEndt[Opt1Int4Pct] = CommFns[Opt1Int4Pct]->aDomega();
 
-    CommFns[Opt2Int4Pct].reset
-        (new ULCommFns
-            (Qc
-            ,GLPic
-            ,glp_naar_disc_rate
-            ,mce_option2_for_7702
-            ,mce_monthly
-            )
+    CommFns[Opt2Int4Pct] = shared_ul_comm_fns
+        (Qc
+        ,GLPic
+        ,glp_naar_disc_rate
+        ,mce_option2_for_7702
+        ,mce_monthly
         );
     DEndt[Opt2Int4Pct] = CommFns[Opt2Int4Pct]->aDomega();
 
     // Commutation functions using 6% min i: always option 1
-    CommFns[Opt1Int6Pct].reset
-        (new ULCommFns
-            (Qc
-            ,GSPic
-            ,gsp_naar_disc_rate
-            ,mce_option1_for_7702
-            ,mce_monthly
-            )
+    CommFns[Opt1Int6Pct] = shared_ul_comm_fns
+        (Qc
+        ,GSPic
+        ,gsp_naar_disc_rate
+        ,mce_option1_for_7702
+        ,mce_monthly
         );
     DEndt[Opt1Int6Pct] = CommFns[Opt1Int6Pct]->aDomega();
 }
@@ -27,7 +27,7 @@
 #include "mc_enum_type_enums.hpp"
 #include "round_to.hpp"
 
-#include <memory>                       // std::unique_ptr
+#include <memory>                       // std::shared_ptr
 #include <vector>
 
 class ULCommFns;
@@ -223,21 +223,10 @@ class Irc7702 final
     double                     GptLimit;   // Guideline limit: max(cum GLP, GSP)
     double                     CumPmts;    // Cumulative payments
 
-    // Commutation functions
-// TODO ?? Apparently the original reason for using smart pointers
-// was to minimize stack usage in a 16-bit environment; clearly that
-// doesn't matter anymore. TAXATION !! Don't do that then.
-//
-// TODO ?? TAXATION !! Consider using std::vector instead of array members.
-    std::unique_ptr<ULCommFns> CommFns         [NumIOBases];
-    // After the Init- functions have executed, we can delete the
-    // rather sizeable ULCommFns objects, as long as we keep the
-    // endowment-year value of D for each basis. TAXATION !! But
-    // not if they're created on the stack. And the meaning of
-    // "sizeable" has changed since that comment was written; the
-    // object contains nine vectors of double, each of potential
-    // length 100, and 9 * 8 * 100 = 7200 bytes is negligible in
-    // the twenty-first century.
+    // Commutation functions, shared with every other instance that
+    // uses the same 7702 mortality and interest rates: see
+    // shared_ul_comm_fns().
+    std::shared_ptr<ULCommFns const> CommFns   [NumIOBases];
     double                     DEndt           [NumIOBases];
 
     // GPT corridor factors for attained ages [IssueAge, 100]
@@ -25,6 +25,7 @@
 #include "view_ex.tpp"
 
 #include "alert.hpp"
+#include "gzip_stream.hpp"
 #include "illustration_view.hpp"
 #include "illustrator.hpp"              // default_cell()
 #include "miscellany.hpp"
@@ -86,7 +87,7 @@ bool IllustrationDocument::OnCreate(wxString const& filename, long int flags)
     else
         {
         std::string f = ValidateAndConvertFilename(filename);
-        std::ifstream ifs(f.c_str());
+        std::ifstream ifs(f.c_str(), ios_in_binary());
         if(!ifs)
             {
             warning()
@@ -97,6 +98,7 @@ bool IllustrationDocument::OnCreate(wxString const& filename, long int flags)
                 ;
             return false;
             }
+        compressed_ = is_gzip_compressed(ifs);
         doc_.read(ifs);
         }
 
@@ -128,7 +130,16 @@ bool IllustrationDocument::DoSaveDocument(wxString const& filename)
 
     std::string f = ValidateAndConvertFilename(filename);
     std::ofstream ofs(f.c_str(), ios_out_trunc_binary());
-    doc_.write(ofs);
+    if(compressed_ || has_gzip_extension(f))
+        {
+        gzip_ostream gz(ofs);
+        doc_.write(gz);
+        gz.finish();
+        }
+    else
+        {
+        doc_.write(ofs);
+        }
     if(!ofs)
         {
         warning() << "Unable to save '" << filename << "'." << LMI_FLUSH;
@@ -69,6 +69,9 @@ class IllustrationDocument
 
     single_cell_document doc_;
 
+    /// A document read from a gzip-compressed file is saved compressed.
+    bool compressed_ {false};
+
     bool is_phony_ {false};
 
     DECLARE_DYNAMIC_CLASS(IllustrationDocument)
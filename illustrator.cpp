@@ -25,11 +25,14 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "census_validation.hpp"
 #include "configurable_settings.hpp"
 #include "custom_io_0.hpp"
 #include "custom_io_1.hpp"
+#include "delta_census.hpp"
 #include "emit_ledger.hpp"
 #include "group_values.hpp"
+#include "gzip_stream.hpp"              // has_gzip_extension()
 #include "handle_exceptions.hpp"
 #include "input.hpp"
 #include "ledgervalues.hpp"
@@ -52,16 +55,27 @@ illustrator::illustrator(mcenum_emission emission)
 {
 }
 
+/// Dispatch on the file's extension.
+///
+/// A gzip-compressed file named, e.g., 'x.cns.gz' is treated as
+/// 'x.cns' would be; only '.cns' and '.ill' files may be compressed.
+
 bool illustrator::operator()(fs::path const& file_path)
 {
-    std::string const extension = fs::extension(file_path);
+    bool const gz = has_gzip_extension(file_path.string());
+    std::string const extension = fs::extension
+        (gz ? fs::change_extension(file_path, "") : file_path
+        );
     if(".cns" == extension)
         {
         Timer timer;
-        multiple_cell_document doc(file_path.string());
-        test_census_consensus(emission_, doc.case_parms()[0], doc.cell_parms());
+        delta_census const census
+            (multiple_cell_document::read_delta_census(file_path.string())
+            );
+        test_census_consensus(emission_, census.case_default(), census);
+        validate_census(census, default_number_of_threads());
         seconds_for_input_ = timer.stop().elapsed_seconds();
-        return operator()(file_path, doc.cell_parms());
+        return operator()(file_path, census);
         }
     else if(".ill" == extension)
         {
@@ -70,6 +84,18 @@ bool illustrator::operator()(fs::path const& file_path)
         seconds_for_input_ = timer.stop().elapsed_seconds();
         return operator()(file_path, doc.input_data());
         }
+    else if(gz)
+        {
+        alarum()
+            << "File '"
+            << file_path
+            << "': compressed '"
+            << extension
+            << "' files are not supported."
+            << LMI_FLUSH
+            ;
+        return false;
+        }
     else if(".ini" == extension)
         {
         Timer timer;
@@ -78,7 +104,7 @@ bool illustrator::operator()(fs::path const& file_path)
         seconds_for_input_ = timer.stop().elapsed_seconds();
         timer.restart();
         IllusVal z(file_path.string());
-        z.run(input);
+        z.run(input, emission_);
         principal_ledger_ = z.ledger();
         seconds_for_calculations_ = timer.stop().elapsed_seconds();
         seconds_for_output_ = emit_ledger(file_path, *z.ledger(), emission_);
@@ -91,13 +117,13 @@ bool illustrator::operator()(fs::path const& file_path)
         Input input;
         bool emit_pdf_too = custom_io_1_read(input, file_path.string());
         seconds_for_input_ = timer.stop().elapsed_seconds();
+        mcenum_emission x = emit_pdf_too ? mce_emit_pdf_file : mce_emit_nothing;
+        mcenum_emission y = static_cast<mcenum_emission>(x | emission_);
         timer.restart();
         IllusVal z(file_path.string());
-        z.run(input);
+        z.run(input, y);
         principal_ledger_ = z.ledger();
         seconds_for_calculations_ = timer.stop().elapsed_seconds();
-        mcenum_emission x = emit_pdf_too ? mce_emit_pdf_file : mce_emit_nothing;
-        mcenum_emission y = static_cast<mcenum_emission>(x | emission_);
         seconds_for_output_ = emit_ledger(file_path, *z.ledger(), y);
         conditionally_show_timings_on_stdout();
         return true;
@@ -120,7 +146,7 @@ bool illustrator::operator()(fs::path const& file_path, Input const& z)
 {
     Timer timer;
     IllusVal IV(file_path.string());
-    IV.run(z);
+    IV.run(z, emission_);
     principal_ledger_ = IV.ledger();
     seconds_for_calculations_ = timer.stop().elapsed_seconds();
     seconds_for_output_ = emit_ledger(file_path, *IV.ledger(), emission_);
@@ -140,6 +166,21 @@ bool illustrator::operator()(fs::path const& file_path, std::vector<Input> const
     return result.completed_normally_;
 }
 
+/// Run a census whose cells are stored sparsely, never holding all
+/// of them in memory as complete Input objects.
+
+bool illustrator::operator()(fs::path const& file_path, delta_census const& z)
+{
+    census_run_result result;
+    run_census runner;
+    result = runner(file_path, emission_, z);
+    principal_ledger_ = runner.composite();
+    seconds_for_calculations_ = result.seconds_for_calculations_;
+    seconds_for_output_       = result.seconds_for_output_      ;
+    conditionally_show_timings_on_stdout();
+    return result.completed_normally_;
+}
+
 void illustrator::conditionally_show_timings_on_stdout() const
 {
     if(mce_emit_timings & emission_)
@@ -216,19 +257,62 @@ Input const& default_cell()
 
 namespace
 {
+/// Uniform access to the cells of a census, whether it is stored as
+/// a std::vector<Input> or as a delta_census, which can be examined
+/// field by field without materializing any cell.
+
+int number_of_cells(std::vector<Input> const& cells)
+{
+    return static_cast<int>(cells.size());
+}
+
+int number_of_cells(delta_census const& cells)
+{
+    return cells.size();
+}
+
+Input const& census_cell(std::vector<Input> const& cells, int j)
+{
+    return cells[j];
+}
+
+delta_census::cell_view census_cell(delta_census const& cells, int j)
+{
+    return cells[j];
+}
+
+bool same_value
+    (Input       const& case_default
+    ,Input       const& cell
+    ,std::string const& field
+    )
+{
+    return case_default[field] == cell[field];
+}
+
+bool same_value
+    (Input                   const& case_default
+    ,delta_census::cell_view const& cell
+    ,std::string             const& field
+    )
+{
+    return case_default[field].str() == cell[field];
+}
+
 /// Throw if run order for any cell does not match case default.
 ///
 /// If lmi had case-only input fields, run order would be one of them.
 
+template<typename Census>
 void assert_consistent_run_order
-    (Input              const& case_default
-    ,std::vector<Input> const& all_cells
+    (Input  const& case_default
+    ,Census const& all_cells
     )
 {
-    int i = 0;
-    for(auto const& cell : all_cells)
+    for(int i = 0; i < number_of_cells(all_cells); ++i)
         {
-        if(case_default["RunOrder"] != cell["RunOrder"])
+        auto const& cell = census_cell(all_cells, i);
+        if(!same_value(case_default, cell, "RunOrder"))
             {
             alarum()
                 << "Case-default run order '"
@@ -241,13 +325,13 @@ void assert_consistent_run_order
                 << LMI_FLUSH
                 ;
             }
-        ++i;
         }
 }
 
+template<typename Census>
 void assert_okay_to_run_group_quote
-    (Input              const& case_default
-    ,std::vector<Input> const& all_cells
+    (Input  const& case_default
+    ,Census const& all_cells
     )
 {
     // There is a surjective mapping of the input fields listed here
@@ -288,12 +372,12 @@ void assert_okay_to_run_group_quote
         alarum() << "Group quotes allowed for new business only." << LMI_FLUSH;
         }
 
-    int i = 0;
-    for(auto const& cell : all_cells)
+    for(int i = 0; i < number_of_cells(all_cells); ++i)
         {
+        auto const& cell = census_cell(all_cells, i);
         for(auto const& field : group_quote_invariant_fields)
             {
-            if(case_default[field] != cell[field])
+            if(!same_value(case_default, cell, field))
                 {
                 alarum()
                     << "Input field '"
@@ -309,7 +393,6 @@ void assert_okay_to_run_group_quote
                     ;
                 }
             }
-        ++i;
         }
 }
 } // Unnamed namespace.
@@ -327,3 +410,16 @@ void test_census_consensus
         }
 }
 
+void test_census_consensus
+    (mcenum_emission           emission
+    ,Input              const& case_default
+    ,delta_census       const& all_cells
+    )
+{
+    assert_consistent_run_order(case_default, all_cells);
+    if(emission & mce_emit_group_quote)
+        {
+        assert_okay_to_run_group_quote(case_default, all_cells);
+        }
+}
+
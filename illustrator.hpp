@@ -35,6 +35,7 @@
 
 class Input;
 class Ledger;
+class delta_census;
 
 /// Sole top-level facility for illustration generation.
 ///
@@ -50,6 +51,7 @@ class LMI_SO illustrator final
     bool operator()(fs::path const&);
     bool operator()(fs::path const&, Input const&);
     bool operator()(fs::path const&, std::vector<Input> const&);
+    bool operator()(fs::path const&, delta_census const&);
 
     void conditionally_show_timings_on_stdout() const;
 
@@ -77,5 +79,11 @@ void LMI_SO test_census_consensus
     ,std::vector<Input> const& all_cells
     );
 
+void LMI_SO test_census_consensus
+    (mcenum_emission           emission
+    ,Input              const& case_default
+    ,delta_census       const& all_cells
+    );
+
 #endif // illustrator_hpp
 
@@ -236,15 +236,14 @@ Input::Input()
     DoTransmogrify();       // Make DOB and age consistent, e.g.
 }
 
-Input::Input(Input const& z)
-    :xml_serializable  <Input>()
-    ,MvcModel                 ()
-    ,MemberSymbolTable <Input>()
-{
-    AscribeMembers();
-    MemberSymbolTable<Input>::assign(z);
-    DoAdaptExternalities();
-}
+/// Copy ctor.
+///
+/// Copying is member-wise: the product database is shared, and the
+/// values gleaned from it are copied, so there is nothing to adapt.
+/// Base class MemberSymbolTable binds members to the copy only when
+/// they're first accessed by name.
+
+Input::Input(Input const&) = default;
 
 /// Destructor.
 ///
@@ -254,12 +253,7 @@ Input::Input(Input const& z)
 
 Input::~Input() = default;
 
-Input& Input::operator=(Input const& z)
-{
-    MemberSymbolTable<Input>::assign(z);
-    DoAdaptExternalities();
-    return *this;
-}
+Input& Input::operator=(Input const&) = default;
 
 bool Input::operator==(Input const& z) const
 {
@@ -42,9 +42,12 @@ class product_database;
 
 #include <boost/operators.hpp>
 
+#include <cstddef>                      // std::size_t
 #include <map>
-#include <memory>                       // std::unique_ptr
+#include <memory>                       // std::shared_ptr
 #include <string>
+#include <tuple>
+#include <utility>                      // std::pair
 #include <vector>
 
 /// Design notes for class input.
@@ -209,6 +212,12 @@ class LMI_SO Input final
     std::string RealizeHoneymoonValueSpread       ();
     std::string RealizeAmountsPaidHistory         ();
 
+    typedef std::string (Input::*sequence_realizer)();
+    static std::vector<std::pair<std::string,sequence_realizer>> const&
+        sequence_realizers();
+    std::string RealizeSequence(std::size_t index);
+    std::string RealizeSequence(std::string const& name);
+
     int must_overwrite_specamt_with_obsolete_history
         (std::string specamt
         ,std::string history
@@ -217,7 +226,8 @@ class LMI_SO Input final
 
     void make_term_rider_consistent(bool aggressively = true);
 
-    std::unique_ptr<product_database> database_;
+    // Shared by copies, which have the same database axes.
+    std::shared_ptr<product_database const> database_;
 
     // Database axes are independent variables; they're "cached" along
     // with the database, which is reset when any of them changes.
@@ -468,6 +478,37 @@ class LMI_SO Input final
     std::vector<tnr_unrestricted_double> FlatExtraRealized_                 ; // tnr_nonnegative_double
     std::vector<tnr_unrestricted_double> HoneymoonValueSpreadRealized_      ; // tnr_interest_rate (new)
     std::vector<tnr_unrestricted_double> AmountsPaidHistoryRealized_        ; // tnr_unrestricted_double
+
+    // Everything besides a sequence's own value that its realization
+    // depends on. Holding the database, rather than its address,
+    // prevents a new database from being mistaken for an old one.
+    typedef std::tuple
+        <int                                     // years_to_maturity()
+        ,int                                     // issue_age()
+        ,int                                     // retirement_age()
+        ,int                                     // inforce_year()
+        ,int                                     // effective_year()
+        ,std::shared_ptr<product_database const>
+        ,bool                                    // ash_nazg()
+        ,bool                                    // mellon()
+        ,bool                                    // custom_io_0()
+        > realization_context;
+
+    /// A sequence's value when it was last realized, and whatever
+    /// diagnostics realizing it produced.
+
+    struct realization_stamp
+    {
+        bool        realized         {false};
+        std::string source;
+        bool        keywords_allowed {false};
+        std::string diagnostics;
+    };
+
+    // Context in which all stamps were made, and one stamp for each
+    // element of sequence_realizers(), in the same order.
+    realization_context            realization_context_;
+    std::vector<realization_stamp> realization_stamps_;
 };
 
 /// Specialization of struct template reconstitutor for this Model
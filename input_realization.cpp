@@ -36,8 +36,10 @@
 #include "value_cast.hpp"
 
 #include <algorithm>
+#include <cstddef>                      // std::size_t
 #include <exception>
 #include <functional>                   // std::bind()
+#include <memory>                       // std::shared_ptr
 #include <sstream>
 #include <utility>                      // std::pair
 
@@ -52,7 +54,7 @@ std::string realize_sequence_string
 {
     try
         {
-        InputSequence s
+        std::shared_ptr<InputSequence const> const s = memoized_input_sequence
             (sequence_string.value()
             ,input.years_to_maturity()
             ,input.issue_age        ()
@@ -60,7 +62,7 @@ std::string realize_sequence_string
             ,input.inforce_year     ()
             ,input.effective_year   ()
             );
-        detail::convert_vector(v, s.seriatim_numbers());
+        detail::convert_vector(v, s->seriatim_numbers());
         }
     catch(std::exception const& e)
         {
@@ -82,7 +84,7 @@ std::string realize_sequence_string
 {
     try
         {
-        InputSequence s
+        std::shared_ptr<InputSequence const> const s = memoized_input_sequence
             (sequence_string.value()
             ,input.years_to_maturity()
             ,input.issue_age        ()
@@ -95,7 +97,7 @@ std::string realize_sequence_string
             );
         detail::convert_vector
             (v
-            ,s.seriatim_keywords()
+            ,s->seriatim_keywords()
             ,keyword_dictionary
             ,default_keyword
             );
@@ -121,7 +123,7 @@ std::string realize_sequence_string
 {
     try
         {
-        InputSequence s
+        std::shared_ptr<InputSequence const> const s = memoized_input_sequence
             (sequence_string.value()
             ,input.years_to_maturity()
             ,input.issue_age        ()
@@ -132,10 +134,10 @@ std::string realize_sequence_string
             ,false
             ,default_keyword
             );
-        detail::convert_vector(vn, s.seriatim_numbers());
+        detail::convert_vector(vn, s->seriatim_numbers());
         detail::convert_vector
             (ve
-            ,s.seriatim_keywords()
+            ,s->seriatim_keywords()
             ,keyword_dictionary
             ,default_keyword
             );
@@ -186,6 +188,111 @@ Input::permissible_specified_amount_strategy_keywords()
     return permissible_keywords;
 }
 
+/// Sequences that RealizeAllSequenceInput() realizes, in order, each
+/// with the function that realizes it.
+
+std::vector<std::pair<std::string,Input::sequence_realizer>> const&
+Input::sequence_realizers()
+{
+    static std::vector<std::pair<std::string,sequence_realizer>> const z =
+        {{"ExtraMonthlyCustodialFee"      , &Input::RealizeExtraMonthlyCustodialFee  }
+        ,{"ExtraCompensationOnAssets"     , &Input::RealizeExtraCompensationOnAssets }
+        ,{"ExtraCompensationOnPremium"    , &Input::RealizeExtraCompensationOnPremium}
+        ,{"PartialMortalityMultiplier"    , &Input::RealizePartialMortalityMultiplier}
+        ,{"CurrentCoiMultiplier"          , &Input::RealizeCurrentCoiMultiplier      }
+        ,{"CashValueEnhancementRate"      , &Input::RealizeCashValueEnhancementRate  }
+        ,{"CorporationTaxBracket"         , &Input::RealizeCorporationTaxBracket     }
+        ,{"TaxBracket"                    , &Input::RealizeTaxBracket                }
+        ,{"ProjectedSalary"               , &Input::RealizeProjectedSalary           }
+        ,{"SpecifiedAmount"               , &Input::RealizeSpecifiedAmount           }
+        ,{"SupplementalSpecifiedAmount"   , &Input::RealizeSupplementalAmount        }
+        ,{"DeathBenefitOption"            , &Input::RealizeDeathBenefitOption        }
+        ,{"Payment"                       , &Input::RealizePayment                   }
+        ,{"PaymentMode"                   , &Input::RealizePaymentMode               }
+        ,{"CorporationPayment"            , &Input::RealizeCorporationPayment        }
+        ,{"CorporationPaymentMode"        , &Input::RealizeCorporationPaymentMode    }
+        ,{"GeneralAccountRate"            , &Input::RealizeGeneralAccountRate        }
+        ,{"SeparateAccountRate"           , &Input::RealizeSeparateAccountRate       }
+        ,{"NewLoan"                       , &Input::RealizeNewLoan                   }
+        ,{"Withdrawal"                    , &Input::RealizeWithdrawal                }
+        ,{"FlatExtra"                     , &Input::RealizeFlatExtra                 }
+        ,{"HoneymoonValueSpread"          , &Input::RealizeHoneymoonValueSpread      }
+        ,{"Inforce7702AAmountsPaidHistory", &Input::RealizeAmountsPaidHistory        }
+        };
+    return z;
+}
+
+/// Realize one sequence, unless it's already realized.
+///
+/// A sequence is realized again only if its value, or whether it
+/// allows keywords, or anything else it depends on has changed since
+/// it was last realized; otherwise, its realized vector is still
+/// valid, and the diagnostics that realizing it produced are simply
+/// repeated. Copies of an Input carry its stamps along with its
+/// realized vectors, so a census cell that was validated as it was
+/// read isn't realized again for each illustration made from it.
+///
+/// Global settings that affect validation are included in the
+/// context, in case they're changed interactively.
+
+std::string Input::RealizeSequence(std::size_t index)
+{
+    global_settings const& g = global_settings::instance();
+    realization_context const context
+        (years_to_maturity()
+        ,issue_age        ()
+        ,retirement_age   ()
+        ,inforce_year     ()
+        ,effective_year   ()
+        ,database_
+        ,g.ash_nazg       ()
+        ,g.mellon         ()
+        ,g.custom_io_0    ()
+        );
+    std::size_t const n = sequence_realizers().size();
+    if(!(context == realization_context_) || n != realization_stamps_.size())
+        {
+        realization_context_ = context;
+        realization_stamps_.assign(n, realization_stamp());
+        }
+
+    LMI_ASSERT(index < n);
+    auto const& realizer = sequence_realizers()[index];
+    datum_sequence const& sequence = *member_cast<datum_sequence>
+        (operator[](realizer.first)
+        );
+    bool const keywords_allowed = !sequence.allowed_keywords().empty();
+    realization_stamp& stamp = realization_stamps_[index];
+    if
+        (  !stamp.realized
+        || stamp.source != sequence.value()
+        || stamp.keywords_allowed != keywords_allowed
+        )
+        {
+        stamp.realized         = true;
+        stamp.source           = sequence.value();
+        stamp.keywords_allowed = keywords_allowed;
+        stamp.diagnostics      = (this->*realizer.second)();
+        }
+    return stamp.diagnostics;
+}
+
+/// Realize one sequence, given its name, unless it's already realized.
+
+std::string Input::RealizeSequence(std::string const& name)
+{
+    auto const& z = sequence_realizers();
+    for(std::size_t j = 0; j < z.size(); ++j)
+        {
+        if(name == z[j].first)
+            {
+            return RealizeSequence(j);
+            }
+        }
+    alarum() << "No sequence named '" << name << "'." << LMI_FLUSH;
+    throw "Unreachable--silences a compiler diagnostic.";
+}
+
 //============================================================================
 std::vector<std::string> Input::RealizeAllSequenceInput(bool report_errors)
 {
@@ -215,34 +322,10 @@ std::vector<std::string> Input::RealizeAllSequenceInput(bool report_errors)
     }
 
     std::vector<std::string> s;
-
-#if defined __MINGW32__ && defined __GNUC__ && __GNUC__ == 2 && __GNUC_MINOR__ == 95
-    // COMPILER !! Here's a mystery: unit test segfaults without this line.
-    s.push_back("");
-#endif // mingw gcc 2.95.2-1 compiler.
-    s.push_back(RealizeExtraMonthlyCustodialFee   ());
-    s.push_back(RealizeExtraCompensationOnAssets  ());
-    s.push_back(RealizeExtraCompensationOnPremium ());
-    s.push_back(RealizePartialMortalityMultiplier ());
-    s.push_back(RealizeCurrentCoiMultiplier       ());
-    s.push_back(RealizeCashValueEnhancementRate   ());
-    s.push_back(RealizeCorporationTaxBracket      ());
-    s.push_back(RealizeTaxBracket                 ());
-    s.push_back(RealizeProjectedSalary            ());
-    s.push_back(RealizeSpecifiedAmount            ());
-    s.push_back(RealizeSupplementalAmount         ());
-    s.push_back(RealizeDeathBenefitOption         ());
-    s.push_back(RealizePayment                    ());
-    s.push_back(RealizePaymentMode                ());
-    s.push_back(RealizeCorporationPayment         ());
-    s.push_back(RealizeCorporationPaymentMode     ());
-    s.push_back(RealizeGeneralAccountRate         ());
-    s.push_back(RealizeSeparateAccountRate        ());
-    s.push_back(RealizeNewLoan                    ());
-    s.push_back(RealizeWithdrawal                 ());
-    s.push_back(RealizeFlatExtra                  ());
-    s.push_back(RealizeHoneymoonValueSpread       ());
-    s.push_back(RealizeAmountsPaidHistory         ());
+    for(std::size_t j = 0; j < sequence_realizers().size(); ++j)
+        {
+        s.push_back(RealizeSequence(j));
+        }
 
     if(report_errors)
         {
@@ -1099,7 +1182,7 @@ void Input::make_term_rider_consistent(bool aggressively)
             {
             double base_spec_amt = total_spec_amt - term_spec_amt;
             SpecifiedAmount = value_cast<std::string>(base_spec_amt);
-            RealizeSpecifiedAmount();
+            RealizeSequence("SpecifiedAmount");
             }
         }
     else
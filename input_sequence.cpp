@@ -32,8 +32,11 @@
 #include "value_cast.hpp"
 
 #include <algorithm>                    // std::fill()
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
 #include <type_traits>
 
 namespace
@@ -396,6 +399,96 @@ std::vector<double> const& InputSequence::seriatim_numbers() const
     return seriatim_numbers_;
 }
 
+/// Construct an InputSequence, or return one constructed earlier
+/// from the same arguments.
+///
+/// An InputSequence depends on nothing but its ctor arguments, and
+/// cannot be modified once constructed, so it can safely be shared.
+/// Cells of a census typically have only a handful of distinct
+/// sequences for each field, so parsing each one only once saves
+/// much of the time spent realizing a census's sequences.
+///
+/// A sequence that cannot be parsed throws on every call, just as
+/// the ctor does; it isn't remembered.
+///
+/// The memo is cleared whenever it grows to memo_limit entries, so
+/// that a census with many distinct sequences cannot make it grow
+/// without bound. This function may be called on any thread.
+
+std::shared_ptr<InputSequence const> memoized_input_sequence
+    (std::string const&              input_expression
+    ,int                             a_years_to_maturity
+    ,int                             a_issue_age
+    ,int                             a_retirement_age
+    ,int                             a_inforce_duration
+    ,int                             a_effective_year
+    ,std::vector<std::string> const& a_allowed_keywords
+    ,bool                            a_keywords_only
+    ,std::string const&              a_default_keyword
+    )
+{
+    typedef std::tuple
+        <std::string
+        ,int
+        ,int
+        ,int
+        ,int
+        ,int
+        ,std::vector<std::string>
+        ,bool
+        ,std::string
+        > key_type;
+    typedef std::map<key_type,std::shared_ptr<InputSequence const>> memo_type;
+    static std::size_t const memo_limit = 10000;
+    static memo_type memo;
+    static std::mutex memo_mutex;
+
+    key_type const key
+        (input_expression
+        ,a_years_to_maturity
+        ,a_issue_age
+        ,a_retirement_age
+        ,a_inforce_duration
+        ,a_effective_year
+        ,a_allowed_keywords
+        ,a_keywords_only
+        ,a_default_keyword
+        );
+
+    {
+    std::lock_guard<std::mutex> lock(memo_mutex);
+    auto const i = memo.find(key);
+    if(memo.end() != i)
+        {
+        return i->second;
+        }
+    }
+
+    // Parse without holding the lock, so that other threads needn't
+    // wait. If two threads parse the same sequence concurrently, the
+    // first one to finish is remembered.
+    std::shared_ptr<InputSequence const> z
+        (new InputSequence
+            (input_expression
+            ,a_years_to_maturity
+            ,a_issue_age
+            ,a_retirement_age
+            ,a_inforce_duration
+            ,a_effective_year
+            ,a_allowed_keywords
+            ,a_keywords_only
+            ,a_default_keyword
+            )
+        );
+
+    std::lock_guard<std::mutex> lock(memo_mutex);
+    if(memo_limit <= memo.size())
+        {
+        memo.clear();
+        }
+    return memo.insert(std::make_pair(key, z)).first->second;
+}
+
 namespace
 {
 void assert_not_insane_or_disordered
@@ -183,6 +183,7 @@
 #include "input_sequence_interval.hpp"
 #include "so_attributes.hpp"
 
+#include <memory>                       // std::shared_ptr
 #include <string>
 #include <vector>
 
@@ -238,5 +239,17 @@ std::string canonicalized_input_sequence(std::vector<T> const& z)
     return InputSequence(z).canonical_form();
 }
 
+std::shared_ptr<InputSequence const> LMI_SO memoized_input_sequence
+    (std::string const&              input_expression
+    ,int                             a_years_to_maturity
+    ,int                             a_issue_age
+    ,int                             a_retirement_age
+    ,int                             a_inforce_duration
+    ,int                             a_effective_year
+    ,std::vector<std::string> const& a_allowed_keywords = {}
+    ,bool                            a_keywords_only    = false
+    ,std::string const&              a_default_keyword  = std::string()
+    );
+
 #endif // input_sequence_hpp
 
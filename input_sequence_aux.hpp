@@ -108,6 +108,7 @@ std::vector<T> convert_vector_type
     )
 {
     std::vector<T> z;
+    z.reserve(ve.size());
     for(auto const& i : ve)
         {
         z.push_back(i.value());
@@ -121,6 +122,7 @@ std::vector<Number> convert_vector_type
     )
 {
     std::vector<Number> z;
+    z.reserve(vr.size());
     for(auto const& i : vr)
         {
         z.push_back(i.value());
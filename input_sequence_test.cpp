@@ -32,6 +32,7 @@ class input_sequence_test
 {
   public:
     static void test();
+    static void test_memoization();
 
   private:
     static void check
@@ -801,9 +802,50 @@ void input_sequence_test::test()
 #endif // defined SHOW_CENSUS_PASTE_TEST_CASES
 }
 
+void input_sequence_test::test_memoization()
+{
+    std::vector<std::string> const k {"a", "b"};
+
+    // The same arguments yield the same object.
+    std::shared_ptr<InputSequence const> const s0 =
+        memoized_input_sequence("1 retirement; 0", 9, 90, 95, 0, 2002);
+    std::shared_ptr<InputSequence const> const s1 =
+        memoized_input_sequence("1 retirement; 0", 9, 90, 95, 0, 2002);
+    BOOST_TEST(s0 == s1);
+
+    // Its values are those of a freshly constructed InputSequence.
+    InputSequence const seq("1 retirement; 0", 9, 90, 95, 0, 2002);
+    BOOST_TEST(seq.seriatim_numbers() == s0->seriatim_numbers());
+    BOOST_TEST_EQUAL(seq.canonical_form(), s0->canonical_form());
+
+    // Any different argument yields a different object.
+    BOOST_TEST(s0 != memoized_input_sequence("1 retirement; 0", 9, 90, 94, 0, 2002));
+    BOOST_TEST(s0 != memoized_input_sequence("1 retirement; 0", 9, 89, 95, 0, 2002));
+    BOOST_TEST(s0 != memoized_input_sequence("1 retirement; 0", 8, 90, 95, 0, 2002));
+    BOOST_TEST(s0 != memoized_input_sequence("1 retirement; 0", 9, 90, 95, 1, 2002));
+    BOOST_TEST(s0 != memoized_input_sequence("1 retirement;0" , 9, 90, 95, 0, 2002));
+
+    std::shared_ptr<InputSequence const> const s2 =
+        memoized_input_sequence("a 3; b", 9, 90, 95, 0, 2002, k, true, "a");
+    BOOST_TEST(s2 == memoized_input_sequence("a 3; b", 9, 90, 95, 0, 2002, k, true, "a"));
+    BOOST_TEST(s2 != memoized_input_sequence("a 3; b", 9, 90, 95, 0, 2002, k, false));
+    BOOST_TEST_EQUAL("b", s2->seriatim_keywords().back());
+
+    // An invalid sequence throws every time.
+    for(int j = 0; j < 2; ++j)
+        {
+        BOOST_TEST_THROW
+            (memoized_input_sequence("1 [2, 1)", 9, 90, 95, 0, 2002)
+            ,std::runtime_error
+            ,""
+            );
+        }
+}
+
 int test_main(int, char*[])
 {
     input_sequence_test::test();
+    input_sequence_test::test_memoization();
 
     return EXIT_SUCCESS;
 }
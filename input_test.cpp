@@ -24,7 +24,10 @@
 // Facilities offered by all of these headers are tested here.
 // Class product_database might appear not to belong, but it's
 // intimately entwined with input.
+#include "census_import.hpp"
+#include "census_validation.hpp"
 #include "database.hpp"
+#include "delta_census.hpp"
 #include "input.hpp"
 #include "multiple_cell_document.hpp"
 #include "single_cell_document.hpp"
@@ -35,6 +38,7 @@
 #include "dbdict.hpp"
 #include "dbnames.hpp"
 #include "global_settings.hpp"
+#include "gzip_stream.hpp"
 #include "miscellany.hpp"
 #include "path_utility.hpp"             // initialize_filesystem()
 #include "test_tools.hpp"
@@ -50,7 +54,10 @@
 #include <fstream>
 #include <functional>                   // std::bind()
 #include <ios>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 class input_test
 {
@@ -60,6 +67,10 @@ class input_test
         test_product_database();
         test_input_class();
         test_document_classes();
+        test_delta_census();
+        test_streaming_reader();
+        test_census_import();
+        test_census_validation();
         test_obsolete_history();
         assay_speed();
         // Rerun this test after assay_speed() because it removes
@@ -71,6 +82,10 @@ class input_test
     static void test_product_database();
     static void test_input_class();
     static void test_document_classes();
+    static void test_delta_census();
+    static void test_streaming_reader();
+    static void test_census_import();
+    static void test_census_validation();
     static void test_obsolete_history();
     static void assay_speed();
 
@@ -93,6 +108,10 @@ class input_test
     static void mete_ill_io();
     static void mete_cns_xsd();
     static void mete_ill_xsd();
+    static void mete_cns_dom();
+    static void mete_cns_stream();
+    static void mete_ill_dom();
+    static void mete_ill_stream();
 };
 
 void input_test::test_product_database()
@@ -301,6 +320,19 @@ void input_test::test_input_class()
     BOOST_TEST(!replica.SeparateAccountRateRealized_.empty());
     BOOST_TEST(0.03125 == replica.SeparateAccountRateRealized_[0]);
 
+    // A sequence is realized again only if it has changed. Mark the
+    // realized vector to show whether it was replaced.
+    original.SeparateAccountRateRealized_[0] = 0.5;
+    original.RealizeAllSequenceInput();
+    BOOST_TEST(0.5 == original.SeparateAccountRateRealized_[0]);
+    Input copy(original);
+    copy.RealizeAllSequenceInput();
+    BOOST_TEST(0.5 == copy.SeparateAccountRateRealized_[0]);
+    original.SeparateAccountRate = "0.0625";
+    original.RealizeAllSequenceInput();
+    BOOST_TEST(0.0625 == original.SeparateAccountRateRealized_[0]);
+    BOOST_TEST(0.5 == copy.SeparateAccountRateRealized_[0]);
+
 /* TODO ?? The code this tests is defective--fix it someday.
     BOOST_TEST(0.4 == original.FundAllocs[0]);
     BOOST_TEST(0.4 == replica.FundAllocs[0]);
@@ -349,6 +381,240 @@ void input_test::test_document_classes()
     test_document_io<S>("sample.ill", "replica.ill", __FILE__, __LINE__, false);
 }
 
+void input_test::test_delta_census()
+{
+    multiple_cell_document const document("sample.cns");
+    delta_census census(multiple_cell_document::read_delta_census("sample.cns"));
+
+    std::vector<Input> const& cells = document.cell_parms();
+    BOOST_TEST_EQUAL(static_cast<int>(cells.size()), census.size());
+    BOOST_TEST(document.case_parms()[0] == census.case_default());
+    BOOST_TEST(document.class_parms() == census.class_defaults());
+    for(int j = 0; j < census.size(); ++j)
+        {
+        BOOST_TEST(cells[j] == census[j].materialize());
+        BOOST_TEST_EQUAL
+            (cells[j]["InsuredName"].str()
+            ,census[j]["InsuredName"]
+            );
+        BOOST_TEST_EQUAL
+            (cells[j]["SpecifiedAmount"].str()
+            ,census[j]["SpecifiedAmount"]
+            );
+        }
+    BOOST_TEST(census.materialize_all() == cells);
+
+    // Cells differ from their defaults in only a few members.
+    int const n = static_cast<int>(census.case_default().member_names().size());
+    BOOST_TEST(census.number_of_differences() < n * census.size() / 4);
+
+    // Writing reproduces the original file.
+    {
+    std::ofstream ofs("replica.cns", ios_out_trunc_binary());
+    multiple_cell_document::write(ofs, census);
+    }
+    bool okay = files_are_identical("sample.cns", "replica.cns");
+    BOOST_TEST(okay);
+    if(okay)
+        {
+        BOOST_TEST(0 == std::remove("replica.cns"));
+        }
+
+    // A cell that is replaced is encoded anew.
+    Input cell(census[0].materialize());
+    cell["InsuredName"] = std::string("Replacement");
+    census.replace(0, cell);
+    BOOST_TEST_EQUAL("Replacement", census[0]["InsuredName"]);
+    BOOST_TEST(cell == census[0].materialize());
+
+    // A cell identical to its default has no differences.
+    census.push_back(census.class_defaults()[0]);
+    BOOST_TEST_EQUAL(0, census[census.size() - 1].number_of_differences());
+
+    BOOST_TEST_THROW
+        (census[0]["NoSuchMember"]
+        ,std::runtime_error
+        ,"Symbol table for class Input ascribes no member named 'NoSuchMember'."
+        );
+}
+
+/// Reading without a DOM must give the same result as reading a DOM.
+
+void input_test::test_streaming_reader()
+{
+    multiple_cell_document dom_cns;
+    dom_cns.parse(xml_lmi::dom_parser("sample.cns"));
+    multiple_cell_document streamed_cns;
+    bool okay = streamed_cns.stream
+        ("sample.cns"
+        ,[&streamed_cns] (Input const& z) {streamed_cns.cell_parms_.push_back(z);}
+        );
+    BOOST_TEST(okay);
+    BOOST_TEST(dom_cns.case_parms () == streamed_cns.case_parms ());
+    BOOST_TEST(dom_cns.class_parms() == streamed_cns.class_parms());
+    BOOST_TEST(dom_cns.cell_parms () == streamed_cns.cell_parms ());
+
+    single_cell_document dom_ill;
+    dom_ill.parse(xml_lmi::dom_parser("sample.ill"));
+    single_cell_document streamed_ill;
+    BOOST_TEST(streamed_ill.stream("sample.ill"));
+    BOOST_TEST(dom_ill.input_data() == streamed_ill.input_data());
+
+    // Files without a "data_source" attribute are left to the DOM
+    // parser, which alone can validate them with a schema.
+    xml_lmi::xml_document document("single_cell_document");
+    xml_lmi::set_attr(document.root_node(), "version", 2);
+    document.root_node() << dom_ill.input_data();
+    document.save("eraseme.ill");
+    single_cell_document external;
+    BOOST_TEST(!external.stream("eraseme.ill"));
+    BOOST_TEST(0 == std::remove("eraseme.ill"));
+
+    // Compressed files are read just as uncompressed ones are, both
+    // with and without a DOM.
+    {
+    std::ifstream ifs("sample.cns", ios_in_binary());
+    std::ofstream ofs("eraseme.cns.gz", ios_out_trunc_binary());
+    gzip_ostream gz(ofs);
+    gz << ifs.rdbuf();
+    gz.finish();
+    }
+    multiple_cell_document gz_dom_cns;
+    gz_dom_cns.parse(xml_lmi::dom_parser("eraseme.cns.gz"));
+    BOOST_TEST(dom_cns.cell_parms() == gz_dom_cns.cell_parms());
+    multiple_cell_document const gz_streamed_cns("eraseme.cns.gz");
+    BOOST_TEST(dom_cns.case_parms () == gz_streamed_cns.case_parms ());
+    BOOST_TEST(dom_cns.class_parms() == gz_streamed_cns.class_parms());
+    BOOST_TEST(dom_cns.cell_parms () == gz_streamed_cns.cell_parms ());
+    BOOST_TEST(0 == std::remove("eraseme.cns.gz"));
+}
+
+/// Importing delimited text must reproduce the imported values, in
+/// order, however many threads are used.
+
+void input_test::test_census_import()
+{
+    multiple_cell_document const document("sample.cns");
+    std::vector<Input> const& cells = document.cell_parms();
+    Input const& case_default = document.case_parms()[0];
+
+    std::vector<std::string> const columns =
+        {"InsuredName", "Gender", "IssueAge", "SpecifiedAmount"};
+    std::string census_data;
+    for(auto const& i : columns)
+        {
+        census_data += i + '\t';
+        }
+    census_data += "\r\n";
+    for(auto const& j : cells)
+        {
+        for(auto const& i : columns)
+            {
+            census_data += j[i].str() + '\t';
+            }
+        census_data += "\n\n";
+        }
+
+    std::vector<Input> imported;
+    for(int threads = 1; threads <= 4; threads += 3)
+        {
+        std::istringstream iss(census_data);
+        census_importer importer(iss, case_default, '\t');
+        BOOST_TEST_EQUAL("No", importer.exemplar()["UseDOB"].str());
+        std::vector<Input> z;
+        int const n = importer.import_cells
+            ([&z] (Input const& cell) {z.push_back(cell);}
+            ,threads
+            );
+        BOOST_TEST_EQUAL(static_cast<int>(cells.size()), n);
+        BOOST_TEST_EQUAL(cells.size(), z.size());
+        for(std::size_t j = 0; j < cells.size(); ++j)
+            {
+            for(auto const& i : columns)
+                {
+                BOOST_TEST_EQUAL(cells[j][i].str(), z[j][i].str());
+                }
+            }
+        if(1 != threads)
+            {
+            BOOST_TEST(imported == z);
+            }
+        imported = z;
+        }
+
+    std::istringstream unknown_column("Gender\tNoSuchMember\n");
+    BOOST_TEST_THROW
+        (census_importer(unknown_column, case_default, '\t')
+        ,std::runtime_error
+        ,"Census column 'NoSuchMember' is not the name of any input field."
+        );
+
+    // The first invalid line is reported, whichever thread finds it.
+    std::istringstream invalid_values("Gender,IssueAge\nMale,45\nNeuter,45\nMale,999\n");
+    census_importer importer(invalid_values, case_default, ',');
+    int n = 0;
+    BOOST_TEST_THROW
+        (importer.import_cells([&n] (Input const&) {++n;}, 4)
+        ,std::runtime_error
+        ,"Line #2, column 'Gender': Value 'Neuter' invalid for type 'mcenum_gender'."
+        );
+    BOOST_TEST_EQUAL(1, n);
+
+    std::vector<std::string> const tsv = split_census_record("a\t\t b \t", '\t');
+    BOOST_TEST(std::vector<std::string>({"a", "", " b "}) == tsv);
+    std::vector<std::string> const csv = split_census_record
+        ("\"Doe, J\",\"say \"\"hi\"\"\",,\"\"\"\"\"\"\"\""
+        ,','
+        );
+    BOOST_TEST(std::vector<std::string>({"Doe, J", "say \"hi\"", "", "\"\"\""}) == csv);
+    BOOST_TEST_THROW
+        (split_census_record("\"open,", ',')
+        ,std::runtime_error
+        ,"Unterminated quotation in census record '\"open,'."
+        );
+}
+
+/// Harmonizing must find the same problems, in the same cells, and
+/// leave the same values, however many threads are used.
+
+void input_test::test_census_validation()
+{
+    multiple_cell_document const document("sample.cns");
+    std::vector<Input> original(document.cell_parms());
+    BOOST_TEST(1 < original.size());
+    BOOST_TEST(diagnose_census_cells(original, 4).empty());
+    validate_census(original, 4);
+
+    original[1]["SpecifiedAmount"] = std::string("nonsense");
+    std::vector<cell_diagnostics> const z = diagnose_census_cells(original, 4);
+    BOOST_TEST_EQUAL(1U, z.size());
+    BOOST_TEST_EQUAL(1, z[0].index);
+    BOOST_TEST(!z[0].message.empty());
+    BOOST_TEST_THROW
+        (validate_census(original, 4)
+        ,std::runtime_error
+        ,lmi_test::what_regex("^Input validation problems in 1 of .* cells:")
+        );
+
+    std::vector<Input> harmonized;
+    for(int threads = 1; threads <= 4; threads += 3)
+        {
+        std::vector<Input> cells(original);
+        std::vector<cell_diagnostics> const d = harmonize_census_cells
+            (cells
+            ,threads
+            );
+        BOOST_TEST_EQUAL(z.size(), d.size());
+        BOOST_TEST_EQUAL(z[0].index, d[0].index);
+        BOOST_TEST_EQUAL(z[0].message, d[0].message);
+        if(1 != threads)
+            {
+            BOOST_TEST(harmonized == cells);
+            }
+        harmonized = cells;
+        }
+}
+
 void input_test::test_obsolete_history()
 {
     Input z;
@@ -420,6 +686,10 @@ void input_test::assay_speed()
         << "\n  'ill' io : " << TimeAnAliquot(mete_ill_io            )
         << "\n  'cns' xsd: " << TimeAnAliquot(mete_cns_xsd           )
         << "\n  'ill' xsd: " << TimeAnAliquot(mete_ill_xsd           )
+        << "\n  'cns' DOM: " << TimeAnAliquot(mete_cns_dom           )
+        << "\n  'cns' SAX: " << TimeAnAliquot(mete_cns_stream        )
+        << "\n  'ill' DOM: " << TimeAnAliquot(mete_ill_dom           )
+        << "\n  'ill' SAX: " << TimeAnAliquot(mete_ill_stream        )
         << '\n'
         ;
 }
@@ -528,6 +798,33 @@ void input_test::mete_ill_xsd()
     scd.validate_with_xsd_schema(ill, scd.xsd_schema_name(scd.class_version()));
 }
 
+void input_test::mete_cns_dom()
+{
+    static multiple_cell_document mcd;
+    mcd.parse(xml_lmi::dom_parser("sample.cns"));
+}
+
+void input_test::mete_cns_stream()
+{
+    static multiple_cell_document mcd;
+    mcd.stream
+        ("sample.cns"
+        ,[] (Input const& z) {mcd.cell_parms_.push_back(z);}
+        );
+}
+
+void input_test::mete_ill_dom()
+{
+    static single_cell_document scd;
+    scd.parse(xml_lmi::dom_parser("sample.ill"));
+}
+
+void input_test::mete_ill_stream()
+{
+    static single_cell_document scd;
+    scd.stream("sample.ill");
+}
+
 int test_main(int, char*[])
 {
     // Absolute paths require "native" name-checking policy for msw.
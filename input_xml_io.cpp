@@ -611,7 +611,7 @@ void Input::redintegrate_ex_post
         // Version 7 introduced 'InforceSpecAmtLoadBase'; previously,
         // the first element of 'SpecamtHistory' had been used in its
         // place, which would have disregarded any term rider.
-        RealizeSpecifiedAmount();
+        RealizeSequence("SpecifiedAmount");
         InforceSpecAmtLoadBase = TermRiderAmount.value() + SpecifiedAmountRealized_[0].value();
         }
 }
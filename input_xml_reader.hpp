@@ -0,0 +1,49 @@
+// Read lmi's own input documents without building a DOM.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef input_xml_reader_hpp
+#define input_xml_reader_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class Input;
+
+/// Called after each cell is read, with the name of its parent
+/// element.
+
+typedef std::function<void(std::string const& parent)> input_cell_sink;
+
+bool LMI_SO read_input_cells
+    (std::string              const& filename
+    ,std::string              const& root_name
+    ,int                             class_version
+    ,std::vector<std::string> const& sections
+    ,Input                         & cell
+    ,input_cell_sink          const& sink
+    );
+
+#endif // input_xml_reader_hpp
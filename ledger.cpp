@@ -25,6 +25,7 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "contains.hpp"
 #include "crc32.hpp"
 #include "global_settings.hpp"
 #include "ledger_invariant.hpp"
@@ -34,31 +35,17 @@
 
 #include <algorithm>
 #include <ostream>
+#include <utility>                      // std::make_pair()
 
-// TODO ?? Is it really a good idea to have shared_ptr data members?
-// If so, should there be a member function
-//   Ledger Ledger::Clone() const
-//   {
-//       Ledger new_ledger(*this);
-//       new_ledger.ledger_map_       = std::shared_ptr<ledger_map_holder>(new ledger_map_holder(*ledger_map_));
-//       new_ledger.ledger_invariant_ = std::shared_ptr<LedgerInvariant>(new LedgerInvariant(*ledger_invariant_));
-//       return new_ledger;
-//   }
-// that would make unshared copies? If not, then Clone() would be
-// unnecessary--the copy ctor would suffice. This is a problem for
-// the (poorly-named) member function AutoScale(), which refuses to
-// be applied to the same object twice (though perhaps that's an
-// unnecessary restriction). What problem did shared_ptr data members
-// solve, and were they the best way to solve it?
-//
-// Perhaps member function AutoScale() should be replaced by, e.g.,
-//   Ledger ScaledLedger() const;
-// yet would that double the memory requirements when a container of
-// ledgers must be retained?
-//
-// See this discussion
+// Ledger data are shared by copies, and copied only when modified.
+// Formerly, shared_ptr data members made copies share data even
+// through modification, which was a problem for AutoScale(), e.g.:
 //   https://savannah.nongnu.org/bugs/?13599
-// of a demonstrable problem stemming from this defect.
+// Now, any member function that modifies the invariant or variant
+// part first calls invariant_to_modify() or variant_map_to_modify(),
+// which make a private copy of that part if it is shared. Thus,
+// copying a ledger costs little, and a copy that is scaled for
+// printing duplicates its data, while the original is unaffected.
 
 //============================================================================
 Ledger::Ledger
@@ -148,6 +135,44 @@ void Ledger::SetRunBases(int length)
         }
 }
 
+/// Retain only those run bases that are wanted.
+///
+/// By default, every basis that the ledger type requires is
+/// calculated. A caller that knows which bases will actually be read
+/// (see run_bases_required()) may discard the others before any
+/// calculations are performed, so that they aren't calculated at all.
+/// Bases that are wanted, but not required by the ledger type, are
+/// ignored.
+///
+/// The current basis must always be wanted, because it determines
+/// payments and other values that the other bases use.
+///
+/// A discarded basis may yet be calculated as a means to some other
+/// end: a solve on the guaranteed basis, for example, runs that basis
+/// even if only current values are to be emitted. Its values are then
+/// silently dropped by SetOneLedgerVariant().
+
+void Ledger::RestrictRunBases(std::vector<mcenum_run_basis> const& wanted)
+{
+    LMI_ASSERT(contains(wanted, mce_run_gen_curr_sep_full));
+
+    ledger_map_t& l_map_rep = variant_map_to_modify().held_;
+    std::vector<mcenum_run_basis> retained;
+    for(auto const& b : run_bases_)
+        {
+        if(contains(wanted, b))
+            {
+            retained.push_back(b);
+            }
+        else
+            {
+            l_map_rep.erase(b);
+            discarded_bases_.push_back(b);
+            }
+        }
+    run_bases_.swap(retained);
+}
+
 /// Set inforce lives to zero after lapse.
 ///
 /// Accomplish this by (1) shortening the inforce-lives vector to the
@@ -180,8 +205,9 @@ void Ledger::ZeroInforceAfterLapse()
     T unlapsed_length = static_cast<T>(1 + lapse_year);
     if(unlapsed_length < original_length)
         {
-        ledger_invariant_->InforceLives.resize(unlapsed_length);
-        ledger_invariant_->InforceLives.resize(original_length);
+        std::vector<double>& lives = invariant_to_modify().InforceLives;
+        lives.resize(unlapsed_length);
+        lives.resize(original_length);
         }
 }
 
@@ -201,6 +227,22 @@ Ledger& Ledger::PlusEq(Ledger const& a_Addend)
     // Perhaps these distinctions should be expressed not as named
     // subcollections of containers but rather as enumerators.
 
+    LMI_ASSERT(is_composite());
+    LMI_ASSERT(!a_Addend.is_composite());
+
+    accumulate(a_Addend, nullptr);
+
+    return *this;
+}
+
+//============================================================================
+// Implementation of PlusEq(), which class composite_reducer also uses
+// to add one partial composite to another. A cell's additive values
+// are weighted by its inforce lives, but a partial composite's values
+// have already been weighted, so they are simply added. If 'a_Error'
+// is not null, sums are compensated: see LedgerBase::PlusEq().
+void Ledger::accumulate(Ledger const& a_Addend, Ledger* a_Error)
+{
     if(ledger_type_ != a_Addend.ledger_type())
         {
         alarum()
@@ -213,23 +255,46 @@ Ledger& Ledger::PlusEq(Ledger const& a_Addend)
     nonillustrated_ = nonillustrated_ || a_Addend.nonillustrated();
     no_can_issue_   = no_can_issue_   || a_Addend.no_can_issue  ();
 
-    LMI_ASSERT(is_composite());
-    LMI_ASSERT(!a_Addend.is_composite());
+    LedgerInvariant const& addend_invariant = *a_Addend.ledger_invariant_;
+    std::vector<double> const weights =
+        a_Addend.is_composite()
+        ? std::vector<double>(addend_invariant.InforceLives.size(), 1.0)
+        : addend_invariant.InforceLives
+        ;
 
-    ledger_map_t& l_map_rep = ledger_map_->held_;
+    ledger_map_t& l_map_rep = variant_map_to_modify().held_;
     ledger_map_t::iterator this_i = l_map_rep.begin();
 
     ledger_map_t const& lm_addend = a_Addend.GetLedgerMap().held();
     ledger_map_t::const_iterator addend_i = lm_addend.begin();
 
-    ledger_invariant_->PlusEq(*a_Addend.ledger_invariant_);
+    ledger_map_t::iterator error_i;
+    if(a_Error)
+        {
+        LMI_ASSERT(a_Error->GetRunBases() == GetRunBases());
+        error_i = a_Error->variant_map_to_modify().held_.begin();
+        }
+
+    invariant_to_modify().PlusEq
+        (addend_invariant
+        ,weights
+        ,a_Error ? &a_Error->invariant_to_modify() : nullptr
+        );
 
     while(this_i != l_map_rep.end() || addend_i != lm_addend.end())
         {
         LMI_ASSERT((*this_i).first == (*addend_i).first);
+        LedgerVariant* error = nullptr;
+        if(a_Error)
+            {
+            LMI_ASSERT((*this_i).first == (*error_i).first);
+            error = &(*error_i).second;
+            ++error_i;
+            }
         (*this_i).second.PlusEq
             ((*addend_i).second
-            ,a_Addend.ledger_invariant_->GetInforceLives()
+            ,weights
+            ,error
             );
         composite_lapse_year_ = std::max
             (composite_lapse_year_
@@ -243,20 +308,53 @@ Ledger& Ledger::PlusEq(Ledger const& a_Addend)
         }
 
     LMI_ASSERT(this_i == l_map_rep.end() && addend_i == lm_addend.end());
+}
 
-    return *this;
+//============================================================================
+// Add only the additive values of 'a_Addend', without weighting. Class
+// composite_reducer uses this to add accumulated rounding errors to
+// their sums.
+void Ledger::add_columns(Ledger const& a_Addend)
+{
+    LMI_ASSERT(a_Addend.GetRunBases() == GetRunBases());
+    std::vector<double> const ones
+        (a_Addend.ledger_invariant_->InforceLives.size()
+        ,1.0
+        );
+
+    LedgerBase& invariant = invariant_to_modify();
+    invariant.PlusEq(*a_Addend.ledger_invariant_, ones);
+
+    ledger_map_t& l_map_rep = variant_map_to_modify().held_;
+    ledger_map_t const& lm_addend = a_Addend.ledger_map_->held_;
+    ledger_map_t::const_iterator addend_i = lm_addend.begin();
+    for(auto& i : l_map_rep)
+        {
+        LMI_ASSERT(i.first == (*addend_i).first);
+        LedgerBase& variant = i.second;
+        variant.PlusEq((*addend_i).second, ones);
+        ++addend_i;
+        }
 }
 
 //============================================================================
 void Ledger::SetLedgerInvariant(LedgerInvariant const& a_Invariant)
 {
-    *ledger_invariant_ = a_Invariant;
+    // The old value needn't be copied if it is shared.
+    if(ledger_invariant_.unique())
+        {
+        *ledger_invariant_ = a_Invariant;
+        }
+    else
+        {
+        ledger_invariant_.reset(new LedgerInvariant(a_Invariant));
+        }
 }
 
 //============================================================================
 void Ledger::SetGuarPremium(double a_GuarPrem)
 {
-    ledger_invariant_->GuarPrem = a_GuarPrem;
+    invariant_to_modify().GuarPrem = a_GuarPrem;
 }
 
 //============================================================================
@@ -265,10 +363,14 @@ void Ledger::SetOneLedgerVariant
     ,LedgerVariant const& a_Variant
     )
 {
-    ledger_map_t& l_map_rep = ledger_map_->held_;
-    if(l_map_rep.count(a_Basis))
+    if(ledger_map_->held().count(a_Basis))
         {
-        l_map_rep[a_Basis] = a_Variant;
+        variant_map_to_modify().held_[a_Basis] = a_Variant;
+        }
+    else if(contains(discarded_bases_, a_Basis))
+        {
+        // Calculated only for some other purpose, such as a solve:
+        // see RestrictRunBases().
         }
     else
         {
@@ -281,6 +383,25 @@ void Ledger::SetOneLedgerVariant
         }
 }
 
+/// Free the memory that one basis's values occupy.
+///
+/// The basis is kept, with values of length zero, so that its values
+/// can be set again, or read back with read_binary_variant() after
+/// they've been written with write_binary_variant(). Until then, this
+/// ledger mustn't be composited or emitted.
+
+void Ledger::ReleaseOneLedgerVariant(mcenum_run_basis a_Basis)
+{
+    LMI_ASSERT(contains(run_bases_, a_Basis));
+    LedgerVariant empty;
+    empty.set_run_basis(a_Basis);
+    // Erase the old values, rather than assigning over them, so that
+    // their storage is actually freed.
+    ledger_map_t& l_map_rep = variant_map_to_modify().held_;
+    l_map_rep.erase(a_Basis);
+    l_map_rep.insert(std::make_pair(a_Basis, empty));
+}
+
 //============================================================================
 int Ledger::GetMaxLength() const
 {
@@ -314,16 +435,24 @@ int Ledger::GetMaxLength() const
 void Ledger::AutoScale()
 {
     double mult = ledger_invariant_->DetermineScaleFactor();
+    bool unscaled = 1.0 == ledger_invariant_->ScaleFactor();
 
-    ledger_map_t& l_map_rep = ledger_map_->held_;
-    for(auto const& i : l_map_rep)
+    for(auto const& i : ledger_map_->held())
         {
         mult = std::min(mult, i.second.DetermineScaleFactor());
+        unscaled = unscaled && 1.0 == i.second.ScaleFactor();
         }
 
-    ledger_invariant_->ApplyScaleFactor(mult);
+    // Scaling by unity would change nothing, so there is no need to
+    // copy shared data merely to apply that scale factor.
+    if(1.0 == mult && unscaled)
+        {
+        return;
+        }
 
-    for(auto& i : l_map_rep)
+    invariant_to_modify().ApplyScaleFactor(mult);
+
+    for(auto& i : variant_map_to_modify().held_)
         {
         i.second.ApplyScaleFactor(mult);
         }
@@ -354,6 +483,32 @@ void Ledger::Spew(std::ostream& os) const
         }
 }
 
+//============================================================================
+// Make the invariant part unshared, so that it can be modified without
+// affecting any copy of this object.
+LedgerInvariant& Ledger::invariant_to_modify()
+{
+    LMI_ASSERT(ledger_invariant_.get());
+    if(!ledger_invariant_.unique())
+        {
+        ledger_invariant_.reset(new LedgerInvariant(*ledger_invariant_));
+        }
+    return *ledger_invariant_;
+}
+
+//============================================================================
+// Make the variant parts unshared, so that they can be modified without
+// affecting any copy of this object.
+ledger_map_holder& Ledger::variant_map_to_modify()
+{
+    LMI_ASSERT(ledger_map_.get());
+    if(!ledger_map_.unique())
+        {
+        ledger_map_.reset(new ledger_map_holder(*ledger_map_));
+        }
+    return *ledger_map_;
+}
+
 //============================================================================
 ledger_map_holder const& Ledger::GetLedgerMap() const
 {
@@ -28,7 +28,9 @@
 #include "so_attributes.hpp"
 #include "xml_lmi.hpp"
 
+#include <cstddef>                      // std::size_t
 #include <iosfwd>
+#include <map>
 #include <memory>                       // std::shared_ptr
 #include <string>
 #include <vector>
@@ -50,8 +52,8 @@
 /// data structure.
 ///
 /// The implicitly-defined copy ctor and copy assignment operator do
-/// the right thing. However, the "right thing" may be somewhat
-/// surprising due to the shared_ptr members; see the comment on
+/// the right thing. Copies share data, which is copied only when one
+/// of them is modified (copy on write); see the comment on
 ///   https://savannah.nongnu.org/bugs/?13599
 /// in the implementation file.
 
@@ -71,11 +73,13 @@ class LMI_SO Ledger
         );
     virtual ~Ledger() = default;
 
+    void RestrictRunBases(std::vector<mcenum_run_basis> const& wanted);
     void ZeroInforceAfterLapse();
     Ledger& PlusEq(Ledger const& a_Addend);
 
     void SetLedgerInvariant(LedgerInvariant const&);
     void SetOneLedgerVariant(mcenum_run_basis, LedgerVariant const&);
+    void ReleaseOneLedgerVariant(mcenum_run_basis);
 
     void SetGuarPremium(double);
 
@@ -110,10 +114,36 @@ class LMI_SO Ledger
     void write       (std::ostream& os) const;
     void write_xsl_fo(std::ostream& os) const;
 
+    void write_binary(std::ostream& os) const;
+    void read_binary (std::istream& is, std::string const& filename);
+
+    void write_binary_variant(std::ostream& os, mcenum_run_basis) const;
+    void read_binary_variant (std::istream& is, std::string const& filename);
+
   private:
+    friend class composite_reducer;
+
+    void accumulate(Ledger const& a_Addend, Ledger* a_Error);
+    void add_columns(Ledger const& a_Addend);
+
+    LedgerInvariant&   invariant_to_modify();
+    ledger_map_holder& variant_map_to_modify();
+
+    void write_values
+        (std::map<std::string,std::string>&              stringscalars
+        ,std::map<std::string,std::vector<std::string>>& stringvectors
+        ,std::vector<std::string>&                       supplemental_columns
+        ) const;
+
     LedgerVariant const& GetOneVariantLedger(mcenum_run_basis) const;
     void SetRunBases(int length);
 
+    // Variant parts of the binary format: see 'ledger_binary_io.cpp'.
+    template<typename Writer>
+    void write_variant(Writer&, mcenum_run_basis) const;
+    template<typename Reader>
+    mcenum_run_basis read_variant(Reader&, std::size_t length);
+
     // These members store ctor arguments whose values cannot be set
     // otherwise. The rationale for storing them here (rather than in
     // class LedgerInvariant, e.g.) is that they are not data from
@@ -144,6 +174,11 @@ class LMI_SO Ledger
     // iterating across all bases without exposing the map's data_type,
     // from which we want to shield other classes where possible.
     std::vector<mcenum_run_basis> run_bases_;
+
+    // Bases removed by RestrictRunBases(). One of them may still be
+    // calculated--e.g., for a solve on the guaranteed basis--but its
+    // values are not stored.
+    std::vector<mcenum_run_basis> discarded_bases_;
 };
 
 std::vector<double> numeric_vector
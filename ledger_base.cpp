@@ -30,7 +30,8 @@
 #include "value_cast.hpp"
 
 #include <algorithm>
-#include <cmath>                        // std::pow()
+#include <cmath>                        // std::fabs(), std::pow()
+#include <cstddef>                      // std::size_t
 #include <functional>
 #include <numeric>
 #include <string>
@@ -77,14 +78,29 @@ void LedgerBase::Alloc()
 
     AllScalars.insert(ScalableScalars       .begin(), ScalableScalars   .end());
     AllScalars.insert(OtherScalars          .begin(), OtherScalars      .end());
+
+    auto const flatten = [](double_vector_map const& m, column_set& c)
+        {
+        c.clear();
+        c.reserve(m.size());
+        for(auto const& i : m)
+            {
+            c.push_back(i.second);
+            }
+        };
+    flatten(BegYearVectors , m_beg_year_columns);
+    flatten(EndYearVectors , m_end_year_columns);
+    flatten(ForborneVectors, m_forborne_columns);
+    flatten(ScalableVectors, m_scalable_columns);
+    flatten(AllVectors     , m_all_columns     );
 }
 
 //============================================================================
 void LedgerBase::Initialize(int a_Length)
 {
-    for(auto& i : AllVectors)
+    for(auto& i : m_all_columns)
         {
-        i.second->assign(a_Length, 0.0);
+        i->assign(a_Length, 0.0);
         }
 
     for(auto& i : AllScalars)
@@ -105,14 +121,10 @@ void LedgerBase::Copy(LedgerBase const& obj)
     //
     // TODO ?? There has to be a way to abstract this.
 
-    double_vector_map::const_iterator obj_svmi = obj.AllVectors.begin();
-    for
-        (double_vector_map::iterator svmi = AllVectors.begin()
-        ;svmi != AllVectors.end()
-        ;svmi++, obj_svmi++
-        )
+    LMI_ASSERT(m_all_columns.size() <= obj.m_all_columns.size());
+    for(std::size_t j = 0; j < m_all_columns.size(); ++j)
         {
-        *(*svmi).second = *(*obj_svmi).second;
+        *m_all_columns[j] = *obj.m_all_columns[j];
         }
 
     scalar_map::const_iterator obj_sci = obj.AllScalars.begin();
@@ -176,53 +188,133 @@ double_vector_map const& LedgerBase::all_vectors() const
 
 namespace
 {
-// Special non-general helper function.
-// The sole use of this function is to multiply y, a vector of values in
-// a ledger, by z, a vector of inforce factors. For this sole intended use,
-// we know that z is nonzero and nondecreasing; therefore, if it ever
-// becomes zero, it remains zero. We can safely break at that point in the
-// interest of speed because adding y times zero to z is a NOP. Note that
-// the inforce factor becomes zero upon lapse.
-    static void x_plus_eq_y_times_z
-        (std::vector<double>& x
+// Special non-general helper functions.
+// Their sole use is to multiply y, a vector of values in a ledger, by
+// inforce factors, and add the product to x. Inforce factors are
+// nonzero and nondecreasing until they become zero upon lapse, after
+// which they remain zero; so PlusEq() determines once how many leading
+// factors are nonzero, and these functions stop at that point, because
+// adding y times zero to x is a NOP. The loops are simple enough for a
+// compiler to vectorize.
+    void x_plus_eq_y_times_z
+        (std::vector<double>&       x
         ,std::vector<double> const& y
-        ,std::vector<double> const& z
+        ,double const*              z
+        ,std::size_t                z_size
+        ,std::size_t                z_nonzero
         )
     {
-        std::vector<double>::iterator ix = x.begin();
-        std::vector<double>::const_iterator iy = y.begin();
-        std::vector<double>::const_iterator iz = z.begin();
         LMI_ASSERT(y.size() <= x.size());
-        LMI_ASSERT(y.size() <= z.size());
-        while(iy != y.end())
+        LMI_ASSERT(y.size() <= z_size);
+        std::size_t const n = std::min(y.size(), z_nonzero);
+        double*       px = x.data();
+        double const* py = y.data();
+        for(std::size_t j = 0; j < n; ++j)
             {
-            LMI_ASSERT(ix != x.end());
-            LMI_ASSERT(iz != z.end());
-            double mult = *iz++;
-            if(0.0 == mult)
-                {
-                break;
-                }
-            // Don't waste time multiplying by one
-            if(1.0 == mult)
-                {
-                *ix++ += *iy++;
-                }
-            else
-                {
-                *ix++ += *iy++ * mult;
-                }
+            px[j] += py[j] * z[j];
+            }
+    }
+
+    void x_plus_eq_y_times_k
+        (std::vector<double>&       x
+        ,std::vector<double> const& y
+        ,double                     k
+        )
+    {
+        LMI_ASSERT(y.size() <= x.size());
+        if(0.0 == k)
+            {
+            return;
+            }
+        std::size_t const n = y.size();
+        double*       px = x.data();
+        double const* py = y.data();
+        for(std::size_t j = 0; j < n; ++j)
+            {
+            px[j] += py[j] * k;
+            }
+    }
+
+    /// Add 'addend' to 'sum', accumulating the rounding error in
+    /// 'error' by Neumaier's variant of Kahan summation.
+
+    inline void compensated_add(double& sum, double& error, double addend)
+    {
+        double const t = sum + addend;
+        if(std::fabs(addend) <= std::fabs(sum))
+            {
+            error += (sum - t) + addend;
+            }
+        else
+            {
+            error += (addend - t) + sum;
+            }
+        sum = t;
+    }
+
+    /// Compensated analogue of x_plus_eq_y_times_z().
+
+    void x_plus_eq_y_times_z
+        (std::vector<double>&       x
+        ,std::vector<double>&       e
+        ,std::vector<double> const& y
+        ,double const*              z
+        ,std::size_t                z_size
+        ,std::size_t                z_nonzero
+        )
+    {
+        LMI_ASSERT(y.size() <= x.size());
+        LMI_ASSERT(x.size() == e.size());
+        LMI_ASSERT(y.size() <= z_size);
+        std::size_t const n = std::min(y.size(), z_nonzero);
+        for(std::size_t j = 0; j < n; ++j)
+            {
+            compensated_add(x[j], e[j], y[j] * z[j]);
+            }
+    }
+
+    /// Compensated analogue of x_plus_eq_y_times_k().
+
+    void x_plus_eq_y_times_k
+        (std::vector<double>&       x
+        ,std::vector<double>&       e
+        ,std::vector<double> const& y
+        ,double                     k
+        )
+    {
+        LMI_ASSERT(y.size() <= x.size());
+        LMI_ASSERT(x.size() == e.size());
+        if(0.0 == k)
+            {
+            return;
+            }
+        std::size_t const n = y.size();
+        for(std::size_t j = 0; j < n; ++j)
+            {
+            compensated_add(x[j], e[j], y[j] * k);
             }
     }
+
+    /// Number of leading nonzero elements.
+
+    std::size_t count_nonzero_prefix(double const* z, std::size_t n)
+    {
+        return std::find(z, z + n, 0.0) - z;
+    }
 } // Unnamed namespace.
 
 //============================================================================
 // TODO ?? Adds cells by policy duration, not calendar duration: when
 // cell issue dates differ, the result is valid only in that probably-
 // unexpected sense.
+//
+// If 'a_Error' is not null, then sums are compensated, and their
+// rounding errors accumulated in the corresponding members of
+// '*a_Error', which must have the same structure as '*this'.
 LedgerBase& LedgerBase::PlusEq
     (LedgerBase const&         a_Addend
     ,std::vector<double> const& a_Inforce
+    ,LedgerBase*               a_Error
     )
 {
     LMI_ASSERT(0.0 != m_scaling_factor);
@@ -230,62 +322,90 @@ LedgerBase& LedgerBase::PlusEq
         {
         alarum() << "Cannot add differently scaled ledgers." << LMI_FLUSH;
         }
+    LMI_ASSERT(!a_Inforce.empty());
+    if(a_Error)
+        {
+        LMI_ASSERT(m_all_columns.size() == a_Error->m_all_columns.size());
+        LMI_ASSERT(ScalableScalars.size() == a_Error->ScalableScalars.size());
+        }
 
-    double_vector_map::const_iterator a_Addend_svmi;
-
-    a_Addend_svmi = a_Addend.BegYearVectors.begin();
-    std::vector<double> const BegYearInforce = a_Inforce;
-    for
-        (double_vector_map::iterator svmi = BegYearVectors.begin()
-        ;svmi != BegYearVectors.end()
-        ;svmi++, a_Addend_svmi++
-        )
+    double const* const beg_year_inforce = a_Inforce.data();
+    std::size_t   const beg_year_size    = a_Inforce.size();
+    std::size_t   const beg_year_nonzero =
+        count_nonzero_prefix(beg_year_inforce, beg_year_size);
+    LMI_ASSERT(m_beg_year_columns.size() == a_Addend.m_beg_year_columns.size());
+    for(std::size_t j = 0; j < m_beg_year_columns.size(); ++j)
         {
+        if(a_Error)
+            {
+            x_plus_eq_y_times_z
+                (*m_beg_year_columns[j]
+                ,*a_Error->m_beg_year_columns[j]
+                ,*a_Addend.m_beg_year_columns[j]
+                ,beg_year_inforce
+                ,beg_year_size
+                ,beg_year_nonzero
+                );
+            continue;
+            }
         x_plus_eq_y_times_z
-            (*(*svmi).second
-            ,*(*a_Addend_svmi).second
-            ,BegYearInforce
+            (*m_beg_year_columns[j]
+            ,*a_Addend.m_beg_year_columns[j]
+            ,beg_year_inforce
+            ,beg_year_size
+            ,beg_year_nonzero
             );
         }
-    LMI_ASSERT(a_Addend_svmi == a_Addend.BegYearVectors.end());
 
-    std::vector<double> const EndYearInforce
-        (a_Inforce.begin() + 1
-        ,a_Inforce.end()
-        );
-    a_Addend_svmi = a_Addend.EndYearVectors.begin();
-    for
-        (double_vector_map::iterator svmi = EndYearVectors.begin()
-        ;svmi != EndYearVectors.end()
-        ;svmi++, a_Addend_svmi++
-        )
+    double const* const end_year_inforce = 1 + a_Inforce.data();
+    std::size_t   const end_year_size    = a_Inforce.size() - 1;
+    std::size_t   const end_year_nonzero =
+        count_nonzero_prefix(end_year_inforce, end_year_size);
+    LMI_ASSERT(m_end_year_columns.size() == a_Addend.m_end_year_columns.size());
+    for(std::size_t j = 0; j < m_end_year_columns.size(); ++j)
         {
+        if(a_Error)
+            {
+            x_plus_eq_y_times_z
+                (*m_end_year_columns[j]
+                ,*a_Error->m_end_year_columns[j]
+                ,*a_Addend.m_end_year_columns[j]
+                ,end_year_inforce
+                ,end_year_size
+                ,end_year_nonzero
+                );
+            continue;
+            }
         x_plus_eq_y_times_z
-            (*(*svmi).second
-            ,*(*a_Addend_svmi).second
-            ,EndYearInforce
+            (*m_end_year_columns[j]
+            ,*a_Addend.m_end_year_columns[j]
+            ,end_year_inforce
+            ,end_year_size
+            ,end_year_nonzero
             );
         }
-    LMI_ASSERT(a_Addend_svmi == a_Addend.EndYearVectors.end());
 
-    std::vector<double> const NumLivesIssued
-        (a_Inforce.size()
-        ,a_Inforce[0]
-        );
-    a_Addend_svmi = a_Addend.ForborneVectors.begin();
-    for
-        (double_vector_map::iterator svmi = ForborneVectors.begin()
-        ;svmi != ForborneVectors.end()
-        ;svmi++, a_Addend_svmi++
-        )
+    double const number_of_lives_issued = a_Inforce[0];
+    LMI_ASSERT(m_forborne_columns.size() == a_Addend.m_forborne_columns.size());
+    for(std::size_t j = 0; j < m_forborne_columns.size(); ++j)
         {
-        x_plus_eq_y_times_z
-            (*(*svmi).second
-            ,*(*a_Addend_svmi).second
-            ,NumLivesIssued
+        LMI_ASSERT(a_Addend.m_forborne_columns[j]->size() <= a_Inforce.size());
+        if(a_Error)
+            {
+            x_plus_eq_y_times_k
+                (*m_forborne_columns[j]
+                ,*a_Error->m_forborne_columns[j]
+                ,*a_Addend.m_forborne_columns[j]
+                ,number_of_lives_issued
+                );
+            continue;
+            }
+        x_plus_eq_y_times_k
+            (*m_forborne_columns[j]
+            ,*a_Addend.m_forborne_columns[j]
+            ,number_of_lives_issued
             );
         }
-    LMI_ASSERT(a_Addend_svmi == a_Addend.ForborneVectors.end());
 
     scalar_map::const_iterator a_Addend_ssmi = a_Addend.ScalableScalars.begin();
     for
@@ -294,7 +414,14 @@ LedgerBase& LedgerBase::PlusEq
         ;ssmi++, a_Addend_ssmi++
         )
         {
-        *(*ssmi).second += *(*a_Addend_ssmi).second * a_Inforce[0];
+        double const addend = *(*a_Addend_ssmi).second * a_Inforce[0];
+        if(a_Error)
+            {
+            double& error = *a_Error->ScalableScalars[(*ssmi).first];
+            compensated_add(*(*ssmi).second, error, addend);
+            continue;
+            }
+        *(*ssmi).second += addend;
         }
     LMI_ASSERT(a_Addend_ssmi == a_Addend.ScalableScalars.end());
 
@@ -313,9 +440,9 @@ double LedgerBase::DetermineScaleFactor() const
     double min_val = 0.0;
     double max_val = 0.0;
 
-    for(auto const& i : ScalableVectors)
+    for(auto const& i : m_scalable_columns)
         {
-        minmax<double> extrema(*i.second);
+        minmax<double> extrema(*i);
         min_val = std::min(min_val, extrema.minimum());
         max_val = std::max(max_val, extrema.maximum());
         }
@@ -427,18 +554,13 @@ void LedgerBase::ApplyScaleFactor(double a_Mult)
         }
     m_scale_unit = look_up_scale_unit(m_scaling_factor);
 
-    // ET !! *i.second *= M;
-    std::vector<double>M(GetLength(), m_scaling_factor);
-    for(auto& i : ScalableVectors)
+    // ET !! *i *= m_scaling_factor;
+    for(auto& i : m_scalable_columns)
         {
-        std::vector<double>& v = *i.second;
-        std::transform
-            (v.begin()
-            ,v.end()
-            ,M.begin()
-            ,v.begin()
-            ,std::multiplies<double>()
-            );
+        for(auto& j : *i)
+            {
+            j *= m_scaling_factor;
+            }
         }
 }
 
@@ -457,9 +579,9 @@ double LedgerBase::ScaleFactor() const
 //============================================================================
 void LedgerBase::UpdateCRC(CRC& crc) const
 {
-    for(auto const& i : AllVectors)
+    for(auto const& i : m_all_columns)
         {
-        crc += *i.second;
+        crc += *i;
         }
 
     for(auto const& i : AllScalars)
@@ -199,6 +199,7 @@ class LMI_SO LedgerBase
     LedgerBase& PlusEq
         (LedgerBase const&         a_Addend
         ,std::vector<double> const& a_Inforce
+        ,LedgerBase*               a_Error = nullptr
         );
 
     virtual int     GetLength() const = 0;
@@ -233,6 +234,18 @@ class LMI_SO LedgerBase
     string_map          Strings;
 
   private:
+    typedef std::vector<std::vector<double>*> column_set;
+
+    // Flat copies of the maps above, made by Alloc(), with pointers in
+    // the same (key) order. Operations that treat a whole class of
+    // vectors alike, without needing names, iterate over these rather
+    // than walking map nodes.
+    column_set          m_beg_year_columns;
+    column_set          m_end_year_columns;
+    column_set          m_forborne_columns;
+    column_set          m_scalable_columns;
+    column_set          m_all_columns;
+
     double              m_scaling_factor;
     std::string         m_scale_unit; // E.g. "thousands", "millions".
 };
@@ -0,0 +1,756 @@
+// Ledger binary input and output.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "ledger.hpp"
+
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "contains.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "mc_enum_types.hpp"
+#include "oecumenic_enumerations.hpp"   // methuselah
+
+#include <cstddef>                      // std::size_t
+#include <cstdint>
+#include <cstring>                      // std::memcmp()
+#include <ios>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Binary ledger format.
+///
+/// Analytics that consume many ledgers need a compact, lossless
+/// format that is fast to load. This format stores each column as a
+/// contiguous array of doubles, aligned on an eight-byte boundary
+/// relative to the beginning of the file, so that a reader that maps
+/// the file into memory can use the arrays in place.
+///
+/// Layout (all integers are unsigned 32-bit unless otherwise noted,
+/// in the writer's native byte order, which the header identifies):
+///
+///   header:
+///     8 bytes: magic "lmiledgr"
+///     version
+///     byte-order mark 0x01020304
+///     ledger type (string); nonillustrated, no_can_issue, and
+///       is_composite (one byte each); composite lapse year (double)
+///     number of parts (one invariant, then each variant)
+///   each part:
+///     run basis (string, empty for the invariant part)
+///     length; scale factor (double); scale unit (string)
+///     count, then (name, count, padding, doubles) for each column
+///     count, then (name, padding, double) for each scalar
+///     count, then (name, string) for each string
+///     count, then (name, count, strings) for each string vector
+///
+/// Strings are stored as a length followed by that many bytes.
+/// Padding is zero bytes, up to the next eight-byte boundary.
+///
+/// Enumerations are stored as their string representations, so that
+/// files remain readable if enumerators are renumbered; changes in
+/// the layout itself require incrementing the version.
+
+namespace
+{
+char const          binary_ledger_magic[] = "lmiledgr";
+std::size_t const   binary_ledger_magic_length = 8;
+std::uint32_t const binary_ledger_version      = 1;
+std::uint32_t const binary_ledger_byte_order   = 0x01020304;
+
+/// Pointers to all data in one part of a ledger, keyed by name.
+///
+/// Class LedgerBase's maps are augmented with members that are not
+/// registered in them, so that no data are lost. The reader fills
+/// data through a mutable view; the writer, which is a const member
+/// of class Ledger, uses a const view.
+
+template<bool is_const>
+struct basic_ledger_part_view
+{
+    template<typename T>
+    using pointer = typename std::conditional<is_const,T const*,T*>::type;
+
+    std::map<std::string,pointer<std::vector<double>>     > vectors;
+    std::map<std::string,pointer<double>                  > scalars;
+    std::map<std::string,pointer<std::string>             > strings;
+    std::map<std::string,pointer<std::vector<std::string>>> string_vectors;
+};
+
+typedef basic_ledger_part_view<false> ledger_part_view;
+typedef basic_ledger_part_view<true > const_ledger_part_view;
+
+class binary_ledger_writer
+{
+  public:
+    explicit binary_ledger_writer(std::ostream& os)
+        :os_     (os)
+        ,offset_ (0)
+        {
+        }
+
+    void raw(void const* p, std::size_t n)
+        {
+        os_.write(static_cast<char const*>(p), static_cast<std::streamsize>(n));
+        offset_ += n;
+        }
+
+    void u32(std::size_t n)
+        {
+        LMI_ASSERT(n <= UINT32_MAX);
+        std::uint32_t const z = static_cast<std::uint32_t>(n);
+        raw(&z, sizeof z);
+        }
+
+    void u8(bool b)
+        {
+        unsigned char const z = b;
+        raw(&z, sizeof z);
+        }
+
+    void pad()
+        {
+        static char const zeros[sizeof(double)] = {};
+        std::size_t const n = (sizeof(double) - offset_ % sizeof(double)) % sizeof(double);
+        raw(zeros, n);
+        }
+
+    void f64(double d)
+        {
+        pad();
+        raw(&d, sizeof d);
+        }
+
+    void str(std::string const& s)
+        {
+        u32(s.size());
+        raw(s.data(), s.size());
+        }
+
+    void doubles(std::vector<double> const& v)
+        {
+        u32(v.size());
+        pad();
+        raw(v.data(), sizeof(double) * v.size());
+        }
+
+    bool good() const {return os_.good();}
+
+  private:
+    std::ostream& os_;
+    std::size_t   offset_;
+};
+
+/// Reader for the binary format.
+///
+/// Counts and lengths read from the file are never trusted: each is
+/// checked against the number of bytes that remain, so that a corrupt
+/// or truncated file is diagnosed before anything is allocated for
+/// it. If the stream can't report its size, it's assumed to be no
+/// larger than any plausible ledger file.
+///
+/// Every diagnostic names the file and the offset of the defect.
+
+class binary_ledger_reader
+{
+  public:
+    binary_ledger_reader(std::istream& is, std::string const& filename)
+        :is_        (is)
+        ,filename_  (filename)
+        ,offset_    (0)
+        ,remaining_ (maximum_unknown_size)
+        {
+        std::istream::pos_type const here = is_.tellg();
+        if(std::istream::pos_type(-1) != here)
+            {
+            is_.seekg(0, std::ios_base::end);
+            std::istream::pos_type const end = is_.tellg();
+            is_.seekg(here);
+            if(std::istream::pos_type(-1) != end && here <= end)
+                {
+                remaining_ = static_cast<std::size_t>(end - here);
+                }
+            }
+        if(!is_)
+            {
+            alarum()
+                << "Unable to read binary ledger file '"
+                << filename_
+                << "'."
+                << LMI_FLUSH
+                ;
+            }
+        }
+
+    /// Begin a diagnostic for a defect at the given offset; the
+    /// caller completes and flushes it.
+
+    std::ostream& complain(std::size_t offset) const
+        {
+        return alarum()
+            << "Binary ledger file '"
+            << filename_
+            << "', offset "
+            << offset
+            << ": "
+            ;
+        }
+
+    std::size_t offset() const {return offset_;}
+
+    void raw(void* p, std::size_t n)
+        {
+        if(remaining_ < n)
+            {
+            complain(offset_) << "file is truncated." << LMI_FLUSH;
+            }
+        is_.read(static_cast<char*>(p), static_cast<std::streamsize>(n));
+        if(!is_)
+            {
+            complain(offset_) << "file is truncated." << LMI_FLUSH;
+            }
+        offset_    += n;
+        remaining_ -= n;
+        }
+
+    std::size_t u32()
+        {
+        std::uint32_t z;
+        raw(&z, sizeof z);
+        return z;
+        }
+
+    /// Read a count of items that each occupy at least 'item_size'
+    /// bytes in the rest of the file, and validate it.
+
+    std::size_t count(std::size_t item_size)
+        {
+        std::size_t const at = offset_;
+        std::size_t const n = u32();
+        if(remaining_ / item_size < n)
+            {
+            complain(at)
+                << "count "
+                << n
+                << " exceeds the "
+                << remaining_
+                << " bytes remaining."
+                << LMI_FLUSH
+                ;
+            }
+        return n;
+        }
+
+    bool u8()
+        {
+        unsigned char z;
+        raw(&z, sizeof z);
+        return 0 != z;
+        }
+
+    void pad()
+        {
+        char ignored[sizeof(double)];
+        raw(ignored, (sizeof(double) - offset_ % sizeof(double)) % sizeof(double));
+        }
+
+    double f64()
+        {
+        pad();
+        double d;
+        raw(&d, sizeof d);
+        return d;
+        }
+
+    std::string str()
+        {
+        std::string s(count(1), '\0');
+        if(!s.empty())
+            {
+            raw(&s[0], s.size());
+            }
+        return s;
+        }
+
+    void doubles(std::vector<double>& v)
+        {
+        v.resize(count(sizeof(double)));
+        pad();
+        if(!v.empty())
+            {
+            raw(v.data(), sizeof(double) * v.size());
+            }
+        }
+
+  private:
+    /// Assumed size of a stream that can't report its size: far more
+    /// than any ledger needs, yet small enough to allocate safely.
+
+    static std::size_t const maximum_unknown_size = 1 << 28;
+
+    std::istream&     is_;
+    std::string const filename_;
+    std::size_t       offset_;
+    std::size_t       remaining_;
+};
+
+template<typename Map>
+typename Map::mapped_type find_or_complain
+    (binary_ledger_reader const& r
+    ,std::size_t                 offset
+    ,Map const&                  m
+    ,std::string const&          name
+    ,char const*                 what
+    )
+{
+    typename Map::const_iterator i = m.find(name);
+    if(m.end() == i)
+        {
+        r.complain(offset)
+            << "unknown "
+            << what
+            << " '"
+            << name
+            << "'."
+            << LMI_FLUSH
+            ;
+        }
+    return i->second;
+}
+
+/// Read a string naming an enumerator of type T, and validate it.
+
+template<typename T>
+T read_enumerator(binary_ledger_reader& r, char const* what)
+{
+    std::size_t const at = r.offset();
+    std::string const name = r.str();
+    if(!contains(all_strings<T>(), name))
+        {
+        r.complain(at)
+            << "unknown "
+            << what
+            << " '"
+            << name
+            << "'."
+            << LMI_FLUSH
+            ;
+        }
+    return mc_enum<T>(name).value();
+}
+
+void write_part(binary_ledger_writer& w, const_ledger_part_view const& v)
+{
+    w.u32(v.vectors.size());
+    for(auto const& i : v.vectors)
+        {
+        w.str(i.first);
+        w.doubles(*i.second);
+        }
+    w.u32(v.scalars.size());
+    for(auto const& i : v.scalars)
+        {
+        w.str(i.first);
+        w.f64(*i.second);
+        }
+    w.u32(v.strings.size());
+    for(auto const& i : v.strings)
+        {
+        w.str(i.first);
+        w.str(*i.second);
+        }
+    w.u32(v.string_vectors.size());
+    for(auto const& i : v.string_vectors)
+        {
+        w.str(i.first);
+        w.u32(i.second->size());
+        for(auto const& j : *i.second)
+            {
+            w.str(j);
+            }
+        }
+}
+
+/// Each item of a part begins with its name, which occupies at least
+/// the four bytes of its length; each string likewise.
+
+std::size_t const minimum_item_size = sizeof(std::uint32_t);
+
+void read_part(binary_ledger_reader& r, ledger_part_view const& v)
+{
+    for(std::size_t n = r.count(minimum_item_size); 0 != n; --n)
+        {
+        std::size_t const at = r.offset();
+        std::string const name = r.str();
+        r.doubles(*find_or_complain(r, at, v.vectors, name, "column"));
+        }
+    for(std::size_t n = r.count(minimum_item_size); 0 != n; --n)
+        {
+        std::size_t const at = r.offset();
+        std::string const name = r.str();
+        *find_or_complain(r, at, v.scalars, name, "scalar") = r.f64();
+        }
+    for(std::size_t n = r.count(minimum_item_size); 0 != n; --n)
+        {
+        std::size_t const at = r.offset();
+        std::string const name = r.str();
+        *find_or_complain(r, at, v.strings, name, "string") = r.str();
+        }
+    for(std::size_t n = r.count(minimum_item_size); 0 != n; --n)
+        {
+        std::size_t const at = r.offset();
+        std::string const name = r.str();
+        std::vector<std::string>& z = *find_or_complain(r, at, v.string_vectors, name, "string vector");
+        z.resize(r.count(minimum_item_size));
+        for(auto& j : z)
+            {
+            j = r.str();
+            }
+        }
+}
+
+template<typename T>
+std::vector<std::string> enum_strings(std::vector<T> const& v)
+{
+    std::vector<std::string> z;
+    z.reserve(v.size());
+    for(auto const& i : v)
+        {
+        z.push_back(i.str());
+        }
+    return z;
+}
+
+template<typename T>
+std::vector<T> enums_from_strings(std::vector<std::string> const& v)
+{
+    std::vector<T> z;
+    z.reserve(v.size());
+    for(auto const& i : v)
+        {
+        z.push_back(T(i));
+        }
+    return z;
+}
+
+/// Data of class LedgerInvariant that are not of type double, held
+/// in temporaries so that they can be handled as the rest are.
+
+struct invariant_extras
+{
+    std::vector<std::string> EeMode;
+    std::vector<std::string> ErMode;
+    std::vector<std::string> DBOpt;
+    std::vector<double>      FundAllocs;
+    double                   irr_precision;
+};
+
+/// Augment a view of class LedgerInvariant's maps with other members.
+///
+/// The constness of the view's pointers follows that of 'z' and 'x'.
+
+template<typename View, typename Invariant, typename Extras>
+void add_invariant_extras(View& v, Invariant& z, Extras& x)
+{
+    v.vectors["InforceLives"   ] = &z.InforceLives   ;
+    v.vectors["FundNumbers"    ] = &z.FundNumbers    ;
+    v.vectors["FundAllocations"] = &z.FundAllocations;
+    v.vectors["FundAllocs"     ] = &x.FundAllocs     ;
+    v.vectors["IrrCsvGuar0"    ] = &z.IrrCsvGuar0    ;
+    v.vectors["IrrDbGuar0"     ] = &z.IrrDbGuar0     ;
+    v.vectors["IrrCsvCurr0"    ] = &z.IrrCsvCurr0    ;
+    v.vectors["IrrDbCurr0"     ] = &z.IrrDbCurr0     ;
+    v.vectors["IrrCsvGuarInput"] = &z.IrrCsvGuarInput;
+    v.vectors["IrrDbGuarInput" ] = &z.IrrDbGuarInput ;
+    v.vectors["IrrCsvCurrInput"] = &z.IrrCsvCurrInput;
+    v.vectors["IrrDbCurrInput" ] = &z.IrrDbCurrInput ;
+
+    v.scalars["irr_precision"  ] = &x.irr_precision  ;
+
+    v.strings["EffDate"        ] = &z.EffDate        ;
+    v.strings["DateOfBirth"    ] = &z.DateOfBirth    ;
+    v.strings["InforceAsOfDate"] = &z.InforceAsOfDate;
+    v.strings["InitErMode"     ] = &z.InitErMode     ;
+    v.strings["InitDBOpt"      ] = &z.InitDBOpt      ;
+
+    v.string_vectors["FundNames"] = &z.FundNames;
+    v.string_vectors["EeMode"   ] = &x.EeMode   ;
+    v.string_vectors["ErMode"   ] = &x.ErMode   ;
+    v.string_vectors["DBOpt"    ] = &x.DBOpt    ;
+}
+} // Unnamed namespace.
+
+/// Write one variant part: its basis, then its data.
+
+template<typename Writer>
+void Ledger::write_variant(Writer& w, mcenum_run_basis basis) const
+{
+    LedgerVariant const& variant = GetOneVariantLedger(basis);
+    const_ledger_part_view u;
+    u.vectors.insert(variant.AllVectors.begin(), variant.AllVectors.end());
+    u.scalars.insert(variant.AllScalars.begin(), variant.AllScalars.end());
+    u.strings.insert(variant.Strings   .begin(), variant.Strings   .end());
+    w.str(mce_run_basis(basis).str());
+    w.u32(variant.GetLength());
+    w.f64(variant.m_scaling_factor);
+    w.str(variant.m_scale_unit);
+    write_part(w, u);
+}
+
+/// Read one variant part, replacing the values of its basis, which
+/// this ledger must have; return that basis.
+
+template<typename Reader>
+mcenum_run_basis Ledger::read_variant(Reader& r, std::size_t length)
+{
+    ledger_map_t& l_map_rep = variant_map_to_modify().held_;
+    std::size_t at = r.offset();
+    mcenum_run_basis const basis = read_enumerator<mcenum_run_basis>(r, "basis");
+    if(!contains(l_map_rep, basis))
+        {
+        r.complain(at)
+            << "unexpected basis '"
+            << mce_run_basis(basis)
+            << "'."
+            << LMI_FLUSH
+            ;
+        }
+    LedgerVariant& variant = l_map_rep[basis];
+    at = r.offset();
+    std::size_t const variant_length = r.u32();
+    if(length != variant_length)
+        {
+        r.complain(at)
+            << "basis '"
+            << mce_run_basis(basis)
+            << "' has length "
+            << variant_length
+            << ", but the invariant part has length "
+            << length
+            << "."
+            << LMI_FLUSH
+            ;
+        }
+    // Values released by ReleaseOneLedgerVariant() have length zero.
+    if(length != static_cast<std::size_t>(variant.GetLength()))
+        {
+        LedgerVariant z(static_cast<int>(length));
+        z.set_run_basis(basis);
+        variant = z;
+        }
+    variant.m_scaling_factor = r.f64();
+    variant.m_scale_unit     = r.str();
+    ledger_part_view u;
+    u.vectors.insert(variant.AllVectors.begin(), variant.AllVectors.end());
+    u.scalars.insert(variant.AllScalars.begin(), variant.AllScalars.end());
+    u.strings.insert(variant.Strings   .begin(), variant.Strings   .end());
+    read_part(r, u);
+    return basis;
+}
+
+/// Write the ledger in the binary format described above.
+
+void Ledger::write_binary(std::ostream& os) const
+{
+    binary_ledger_writer w(os);
+    w.raw(binary_ledger_magic, binary_ledger_magic_length);
+    w.u32(binary_ledger_version);
+    w.u32(binary_ledger_byte_order);
+    w.str(mce_ledger_type(ledger_type_).str());
+    w.u8(nonillustrated_);
+    w.u8(no_can_issue_);
+    w.u8(is_composite_);
+    w.f64(composite_lapse_year_);
+    w.u32(1 + ledger_map_->held().size());
+
+    LedgerInvariant const& invariant = *ledger_invariant_;
+    invariant_extras const x =
+        {enum_strings(invariant.EeMode)
+        ,enum_strings(invariant.ErMode)
+        ,enum_strings(invariant.DBOpt )
+        ,std::vector<double>(invariant.FundAllocs.begin(), invariant.FundAllocs.end())
+        ,static_cast<double>(invariant.irr_precision)
+        };
+    const_ledger_part_view v;
+    v.vectors.insert(invariant.AllVectors.begin(), invariant.AllVectors.end());
+    v.scalars.insert(invariant.AllScalars.begin(), invariant.AllScalars.end());
+    v.strings.insert(invariant.Strings   .begin(), invariant.Strings   .end());
+    add_invariant_extras(v, invariant, x);
+    w.str("");
+    w.u32(invariant.GetLength());
+    w.f64(invariant.m_scaling_factor);
+    w.str(invariant.m_scale_unit);
+    write_part(w, v);
+
+    for(auto const& i : ledger_map_->held())
+        {
+        write_variant(w, i.first);
+        }
+
+    if(!w.good())
+        {
+        alarum() << "Unable to write binary ledger." << LMI_FLUSH;
+        }
+}
+
+/// Replace this ledger's contents with data in the binary format.
+///
+/// The file name is used only in diagnostics.
+///
+/// The invariant and variant parts are newly allocated, so that any
+/// copies of this object that shared them are unaffected.
+
+void Ledger::read_binary(std::istream& is, std::string const& filename)
+{
+    binary_ledger_reader r(is, filename);
+    char magic[binary_ledger_magic_length];
+    r.raw(magic, binary_ledger_magic_length);
+    if(0 != std::memcmp(magic, binary_ledger_magic, binary_ledger_magic_length))
+        {
+        r.complain(0) << "not a binary ledger file." << LMI_FLUSH;
+        }
+    std::size_t at = r.offset();
+    std::size_t const version = r.u32();
+    if(binary_ledger_version != version)
+        {
+        r.complain(at)
+            << "version "
+            << version
+            << " is not supported."
+            << LMI_FLUSH
+            ;
+        }
+    at = r.offset();
+    if(binary_ledger_byte_order != r.u32())
+        {
+        r.complain(at) << "written with other byte order." << LMI_FLUSH;
+        }
+    ledger_type_          = read_enumerator<mcenum_ledger_type>(r, "ledger type");
+    nonillustrated_       = r.u8();
+    no_can_issue_         = r.u8();
+    is_composite_         = r.u8();
+    composite_lapse_year_ = r.f64();
+    std::size_t const parts_offset = r.offset();
+    std::size_t const number_of_parts = r.count(minimum_item_size);
+    if(0 == number_of_parts)
+        {
+        r.complain(parts_offset) << "file has no invariant part." << LMI_FLUSH;
+        }
+
+    at = r.offset();
+    std::string const invariant_basis = r.str();
+    if(!invariant_basis.empty())
+        {
+        r.complain(at)
+            << "invariant part has basis '"
+            << invariant_basis
+            << "', which should be empty."
+            << LMI_FLUSH
+            ;
+        }
+    at = r.offset();
+    std::size_t const length = r.u32();
+    if(methuselah < length)
+        {
+        r.complain(at)
+            << "length "
+            << length
+            << " exceeds "
+            << methuselah
+            << "."
+            << LMI_FLUSH
+            ;
+        }
+    ledger_map_      .reset(new ledger_map_holder);
+    ledger_invariant_.reset(new LedgerInvariant(static_cast<int>(length)));
+    run_bases_.clear();
+    discarded_bases_.clear();
+    SetRunBases(static_cast<int>(length));
+    if(1 + ledger_map_->held().size() < number_of_parts)
+        {
+        r.complain(parts_offset)
+            << "file has "
+            << number_of_parts - 1
+            << " variants, but its ledger type allows only "
+            << ledger_map_->held().size()
+            << "."
+            << LMI_FLUSH
+            ;
+        }
+
+    LedgerInvariant& invariant = *ledger_invariant_;
+    invariant.m_scaling_factor = r.f64();
+    invariant.m_scale_unit     = r.str();
+    invariant_extras x;
+    ledger_part_view v;
+    v.vectors.insert(invariant.AllVectors.begin(), invariant.AllVectors.end());
+    v.scalars.insert(invariant.AllScalars.begin(), invariant.AllScalars.end());
+    v.strings.insert(invariant.Strings   .begin(), invariant.Strings   .end());
+    add_invariant_extras(v, invariant, x);
+    read_part(r, v);
+    invariant.EeMode        = enums_from_strings<mce_mode >(x.EeMode);
+    invariant.ErMode        = enums_from_strings<mce_mode >(x.ErMode);
+    invariant.DBOpt         = enums_from_strings<mce_dbopt>(x.DBOpt );
+    invariant.FundAllocs.assign(x.FundAllocs.begin(), x.FundAllocs.end());
+    invariant.irr_precision = static_cast<int>(x.irr_precision);
+
+    // The ledger may have been restricted to fewer bases than its
+    // type requires; see Ledger::RestrictRunBases().
+    std::vector<mcenum_run_basis> bases_read;
+    for(std::size_t j = 1; j < number_of_parts; ++j)
+        {
+        bases_read.push_back(read_variant(r, length));
+        }
+    RestrictRunBases(bases_read);
+}
+
+/// Write one basis's values as a variant part, with no header.
+///
+/// This isn't a file format: it's meant only for values that are set
+/// aside temporarily (see ReleaseOneLedgerVariant()) and read back by
+/// read_binary_variant() in the same run.
+
+void Ledger::write_binary_variant(std::ostream& os, mcenum_run_basis b) const
+{
+    binary_ledger_writer w(os);
+    write_variant(w, b);
+    if(!w.good())
+        {
+        alarum() << "Unable to write binary ledger." << LMI_FLUSH;
+        }
+}
+
+/// Read one basis's values written by write_binary_variant().
+///
+/// That basis must not have been removed from this ledger, and its
+/// values must have the invariant part's length.
+
+void Ledger::read_binary_variant(std::istream& is, std::string const& filename)
+{
+    binary_ledger_reader r(is, filename);
+    read_variant(r, static_cast<std::size_t>(ledger_invariant_->GetLength()));
+}
@@ -0,0 +1,323 @@
+// Binary ledger format--unit test.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "ledger.hpp"
+
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "mc_enum_types.hpp"
+#include "test_tools.hpp"
+
+#include <cstddef>                      // std::size_t
+#include <cstdint>
+#include <cstring>                      // std::memcpy()
+#include <ios>                          // std::streamoff
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+int const ledger_length = 40;
+
+/// Fill every column with values unique to it, including values that
+/// a decimal representation wouldn't preserve exactly.
+
+void fill_columns(double_vector_map const& columns, double seed)
+{
+    for(auto const& i : columns)
+        {
+        std::vector<double>& v = *i.second;
+        for(std::size_t j = 0; j < v.size(); ++j)
+            {
+            v[j] = seed + static_cast<double>(j) / 3.0;
+            }
+        seed += 1000.0;
+        }
+}
+
+/// A ledger with every run basis that its type requires, and every
+/// column distinct.
+
+Ledger sample_ledger()
+{
+    Ledger z(ledger_length, mce_ill_reg, false, false, false);
+
+    LedgerInvariant invariant(ledger_length);
+    fill_columns(invariant.all_vectors(), 1.0);
+    invariant.EeMode.assign(ledger_length, mce_mode(mce_monthly));
+    invariant.ErMode.assign(ledger_length, mce_mode(mce_annual));
+    invariant.DBOpt .assign(ledger_length, mce_dbopt(mce_option2));
+    invariant.FundNames.push_back("Money market");
+    invariant.FundNames.push_back("Equity index");
+    invariant.EffDate       = "2017-01-01";
+    invariant.irr_precision = 4;
+    z.SetLedgerInvariant(invariant);
+
+    double seed = 0.5;
+    for(auto const& basis : z.GetRunBases())
+        {
+        LedgerVariant variant(ledger_length);
+        variant.set_run_basis(basis);
+        fill_columns(variant.all_vectors(), seed);
+        variant.LapseYear = ledger_length;
+        z.SetOneLedgerVariant(basis, variant);
+        seed += 1.0e6;
+        }
+    return z;
+}
+
+std::string binary_image(Ledger const& ledger)
+{
+    std::ostringstream oss;
+    ledger.write_binary(oss);
+    return oss.str();
+}
+
+Ledger read_image(std::string const& image)
+{
+    std::istringstream iss(image);
+    Ledger z(1, mce_ill_reg, false, false, false);
+    z.read_binary(iss, "sample.ledger");
+    return z;
+}
+
+bool same_columns(double_vector_map const& a, double_vector_map const& b)
+{
+    if(a.size() != b.size())
+        {
+        return false;
+        }
+    for(auto i = a.begin(), j = b.begin(); i != a.end(); ++i, ++j)
+        {
+        std::vector<double> const& x = *i->second;
+        std::vector<double> const& y = *j->second;
+        if(i->first != j->first || x.size() != y.size())
+            {
+            return false;
+            }
+        for(std::size_t k = 0; k < x.size(); ++k)
+            {
+            if(x[k] != y[k])
+                {
+                return false;
+                }
+            }
+        }
+    return true;
+}
+
+/// Overwrite four bytes of a binary image with an integer.
+
+void patch_u32(std::string& image, std::size_t offset, std::uint32_t n)
+{
+    std::memcpy(&image[offset], &n, sizeof n);
+}
+
+std::uint32_t image_u32(std::string const& image, std::size_t offset)
+{
+    std::uint32_t n;
+    std::memcpy(&n, &image[offset], sizeof n);
+    return n;
+}
+
+// Offsets of header fields: see the layout in the implementation.
+std::size_t const version_offset          = 8;
+std::size_t const ledger_type_size_offset = 16;
+
+/// Offset of the invariant part's basis, which follows the ledger
+/// type, three flags, a padded double, and the number of parts.
+
+std::size_t invariant_basis_offset(std::string const& image)
+{
+    std::size_t const flags_end =
+          ledger_type_size_offset
+        + sizeof(std::uint32_t)
+        + image_u32(image, ledger_type_size_offset)
+        + 3
+        ;
+    std::size_t const aligned = (flags_end + 7) / 8 * 8;
+    return aligned + sizeof(double) + sizeof(std::uint32_t);
+}
+} // Unnamed namespace.
+
+void test_round_trip()
+{
+    Ledger const original = sample_ledger();
+    std::string const image = binary_image(original);
+    Ledger const replica = read_image(image);
+
+    BOOST_TEST(original.GetRunBases() == replica.GetRunBases());
+    BOOST_TEST_EQUAL(original.GetMaxLength(), replica.GetMaxLength());
+
+    LedgerInvariant const& a = original.GetLedgerInvariant();
+    LedgerInvariant const& b = replica .GetLedgerInvariant();
+    BOOST_TEST(same_columns(a.all_vectors(), b.all_vectors()));
+    BOOST_TEST(a.EeMode    == b.EeMode   );
+    BOOST_TEST(a.ErMode    == b.ErMode   );
+    BOOST_TEST(a.DBOpt     == b.DBOpt    );
+    BOOST_TEST(a.FundNames == b.FundNames);
+    BOOST_TEST_EQUAL(a.EffDate      , b.EffDate      );
+    BOOST_TEST_EQUAL(a.irr_precision, b.irr_precision);
+
+    auto const& x = original.GetLedgerMap().held();
+    auto const& y = replica .GetLedgerMap().held();
+    BOOST_TEST_EQUAL(x.size(), y.size());
+    for(auto i = x.begin(), j = y.begin(); i != x.end(); ++i, ++j)
+        {
+        BOOST_TEST(i->first == j->first);
+        BOOST_TEST(same_columns(i->second.all_vectors(), j->second.all_vectors()));
+        BOOST_TEST_EQUAL(i->second.LapseYear, j->second.LapseYear);
+        }
+
+    // Everything written is read: writing the replica reproduces the
+    // original image exactly, including scalars and strings.
+    BOOST_TEST(image == binary_image(replica));
+}
+
+/// Values of one basis, written, released, and read back, are
+/// restored exactly.
+
+void test_variant_round_trip()
+{
+    Ledger const original = sample_ledger();
+    std::string const image = binary_image(original);
+    Ledger replica = original;
+
+    std::stringstream ss;
+    std::vector<std::streamoff> offsets;
+    for(auto const& basis : replica.GetRunBases())
+        {
+        offsets.push_back(ss.tellp());
+        replica.write_binary_variant(ss, basis);
+        replica.ReleaseOneLedgerVariant(basis);
+        }
+    for(auto const& i : replica.GetLedgerMap().held())
+        {
+        BOOST_TEST_EQUAL(0, i.second.GetLength());
+        }
+    // The original shared its values with the replica, but kept them.
+    BOOST_TEST(image == binary_image(original));
+
+    for(auto const& offset : offsets)
+        {
+        ss.seekg(offset);
+        replica.read_binary_variant(ss, "spilled");
+        }
+    BOOST_TEST(image == binary_image(replica));
+
+    // Values can't be read back into a ledger that lacks their basis.
+    Ledger restricted = sample_ledger();
+    std::vector<mcenum_run_basis> const current(1, mce_run_gen_curr_sep_full);
+    restricted.RestrictRunBases(current);
+    std::stringstream guar;
+    original.write_binary_variant(guar, mce_run_gen_guar_sep_full);
+    BOOST_TEST_THROW
+        (restricted.read_binary_variant(guar, "spilled")
+        ,std::runtime_error
+        ,"Binary ledger file 'spilled', offset 0: unexpected basis '"
+        + mce_run_basis(mce_run_gen_guar_sep_full).str()
+        + "'."
+        );
+}
+
+void test_malformed_files()
+{
+    std::string const image = binary_image(sample_ledger());
+
+    for(std::size_t n : {std::size_t(0), std::size_t(4), std::size_t(20), image.size() / 2, image.size() - 1})
+        {
+        BOOST_TEST_THROW
+            (read_image(image.substr(0, n))
+            ,std::runtime_error
+            ,lmi_test::what_regex("^Binary ledger file 'sample.ledger', offset [0-9]+: ")
+            );
+        }
+
+    std::string bad_magic(image);
+    bad_magic[0] = 'L';
+    BOOST_TEST_THROW
+        (read_image(bad_magic)
+        ,std::runtime_error
+        ,"Binary ledger file 'sample.ledger', offset 0: not a binary ledger file."
+        );
+
+    std::string bad_version(image);
+    patch_u32(bad_version, version_offset, 99);
+    BOOST_TEST_THROW
+        (read_image(bad_version)
+        ,std::runtime_error
+        ,"Binary ledger file 'sample.ledger', offset 8: version 99 is not supported."
+        );
+
+    // A corrupt count is diagnosed before anything is allocated.
+    std::string bad_count(image);
+    patch_u32(bad_count, ledger_type_size_offset, 0x7fffffff);
+    BOOST_TEST_THROW
+        (read_image(bad_count)
+        ,std::runtime_error
+        ,lmi_test::what_regex
+            ("^Binary ledger file 'sample.ledger', offset 16: count 2147483647 exceeds"
+            )
+        );
+
+    // The invariant part's basis must be empty; here, it's taken to
+    // be the four bytes of the length that follows it.
+    std::string bad_basis(image);
+    std::size_t const basis_offset = invariant_basis_offset(image);
+    BOOST_TEST_EQUAL(0, image_u32(image, basis_offset));
+    BOOST_TEST_EQUAL(ledger_length, image_u32(image, 4 + basis_offset));
+    patch_u32(bad_basis, basis_offset, 4);
+    BOOST_TEST_THROW
+        (read_image(bad_basis)
+        ,std::runtime_error
+        ,lmi_test::what_regex
+            ("^Binary ledger file 'sample.ledger', offset [0-9]+: invariant part has basis"
+            )
+        );
+
+    // Each variant's length must match the invariant part's.
+    std::string bad_length(image);
+    std::string const basis = mce_run_basis(sample_ledger().GetRunBases().front()).str();
+    std::size_t const length_offset = image.find(basis) + basis.size();
+    BOOST_TEST_EQUAL(ledger_length, image_u32(image, length_offset));
+    patch_u32(bad_length, length_offset, 1 + ledger_length);
+    BOOST_TEST_THROW
+        (read_image(bad_length)
+        ,std::runtime_error
+        ,"Binary ledger file 'sample.ledger', offset "
+        + std::to_string(length_offset)
+        + ": basis '"
+        + basis
+        + "' has length 41, but the invariant part has length 40."
+        );
+}
+
+int test_main(int, char*[])
+{
+    test_round_trip();
+    test_variant_round_trip();
+    test_malformed_files();
+    return EXIT_SUCCESS;
+}
@@ -955,7 +955,21 @@ if(1 != b->yare_input_.InforceDataSource)
 //============================================================================
 LedgerInvariant& LedgerInvariant::PlusEq(LedgerInvariant const& a_Addend)
 {
-    LedgerBase::PlusEq(a_Addend, a_Addend.InforceLives);
+    return PlusEq(a_Addend, a_Addend.InforceLives, nullptr);
+}
+
+//============================================================================
+// Add a cell, weighting additive vectors by 'a_Inforce', which is
+// ordinarily the addend's own inforce lives, but is unity when the
+// addend is itself a partial composite. Cf. LedgerBase::PlusEq() for
+// the meaning of 'a_Error'.
+LedgerInvariant& LedgerInvariant::PlusEq
+    (LedgerInvariant const&     a_Addend
+    ,std::vector<double> const& a_Inforce
+    ,LedgerInvariant*           a_Error
+    )
+{
+    LedgerBase::PlusEq(a_Addend, a_Inforce, a_Error);
 
     irr_precision = a_Addend.irr_precision;
 
@@ -974,6 +988,8 @@ LedgerInvariant& LedgerInvariant::PlusEq(LedgerInvariant const& a_Addend)
         }
     // InforceLives is one longer than the other vectors.
     InforceLives        [Max] += a_Addend.InforceLives  [Max];
+    // Inforce lives are not compensated; their sums are nonetheless
+    // reproducible whenever the order of summation is fixed.
 
 //  GenderDistinct          = 0;
 //  GenderBlended           = 0;
@@ -52,6 +52,11 @@ class LMI_SO LedgerInvariant
     void Init(BasicValues const*);
 
     LedgerInvariant& PlusEq(LedgerInvariant const& a_Addend);
+    LedgerInvariant& PlusEq
+        (LedgerInvariant const&     a_Addend
+        ,std::vector<double> const& a_Inforce
+        ,LedgerInvariant*           a_Error
+        );
 
     bool                         IsFullyInitialized()    const;
     int                  GetLength()             const override;
@@ -0,0 +1,123 @@
+// Ledger--unit test.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "ledger.hpp"
+
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "mc_enum_types.hpp"
+#include "test_tools.hpp"
+
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+int const ledger_length = 10;
+
+LedgerVariant make_variant(mcenum_run_basis basis, double account_value)
+{
+    LedgerVariant z(ledger_length);
+    z.set_run_basis(basis);
+    for(auto& i : z.AcctVal)
+        {
+        i = account_value;
+        }
+    return z;
+}
+} // Unnamed namespace.
+
+/// Calculate only current values, as for a group roster, for a cell
+/// that solves on the guaranteed basis.
+///
+/// AccountValue::SolveTest() runs the guaranteed basis repeatedly,
+/// and each run ends by storing its values in the ledger. The values
+/// it needs are read from the AccountValue object, so the ledger
+/// simply drops them.
+
+void test_guaranteed_solve_with_restricted_bases()
+{
+    Ledger ledger(ledger_length, mce_ill_reg, false, false, false);
+    ledger.SetLedgerInvariant(LedgerInvariant(ledger_length));
+    ledger.RestrictRunBases({mce_run_gen_curr_sep_full});
+    BOOST_TEST_EQUAL(1, ledger.GetRunBases().size());
+
+    // The solve runs first...
+    ledger.SetOneLedgerVariant
+        (mce_run_gen_guar_sep_full
+        ,make_variant(mce_run_gen_guar_sep_full, 1.0)
+        );
+    ledger.SetOneLedgerVariant
+        (mce_run_gen_guar_sep_full
+        ,make_variant(mce_run_gen_guar_sep_full, 2.0)
+        );
+    // ...and then every retained basis is run.
+    ledger.SetOneLedgerVariant
+        (mce_run_gen_curr_sep_full
+        ,make_variant(mce_run_gen_curr_sep_full, 3.0)
+        );
+
+    BOOST_TEST_EQUAL(1, ledger.GetRunBases().size());
+    BOOST_TEST(mce_run_gen_curr_sep_full == ledger.GetRunBases().front());
+    BOOST_TEST_EQUAL(3.0, ledger.GetCurrFull().AcctVal.back());
+    BOOST_TEST_THROW
+        (ledger.GetGuarFull()
+        ,std::runtime_error
+        ,""
+        );
+}
+
+/// A basis that the ledger type never uses is still an error.
+
+void test_unused_basis()
+{
+    Ledger ledger(ledger_length, mce_nasd, false, false, false);
+    ledger.RestrictRunBases({mce_run_gen_curr_sep_full});
+    BOOST_TEST_THROW
+        (ledger.SetOneLedgerVariant
+            (mce_run_gen_mdpt_sep_full
+            ,make_variant(mce_run_gen_mdpt_sep_full, 1.0)
+            )
+        ,std::runtime_error
+        ,"Failed attempt to set ledger for unused basis"
+         " 'mdpt charges and genacct int, no sepacct'."
+        );
+
+    Ledger unrestricted(ledger_length, mce_nasd, false, false, false);
+    BOOST_TEST_THROW
+        (unrestricted.SetOneLedgerVariant
+            (mce_run_gen_mdpt_sep_full
+            ,make_variant(mce_run_gen_mdpt_sep_full, 1.0)
+            )
+        ,std::runtime_error
+        ,"Failed attempt to set ledger for unused basis"
+         " 'mdpt charges and genacct int, no sepacct'."
+        );
+}
+
+int test_main(int, char*[])
+{
+    test_guaranteed_solve_with_restricted_bases();
+    test_unused_basis();
+    return EXIT_SUCCESS;
+}
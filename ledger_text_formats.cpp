@@ -1162,44 +1162,37 @@ inline LedgerVariant   const& FlatTextLedgerPrinter::mdpt_() const
 ///
 /// The first element of the std::pair argument is the number of
 /// digits to be shown to the right of the decimal point.
+///
+/// The result is the same as inserting the value into a stream imbued
+/// with comma_punct, but format_with_commas() writes it directly into
+/// a buffer, which matters because every number in every ledger is
+/// formatted here.
 
 std::string ledger_format
     (double                            d
     ,std::pair<int,oenum_format_style> f
     )
 {
-    std::stringstream interpreter;
-    std::locale loc;
-    std::locale new_loc(loc, new comma_punct);
-    interpreter.imbue(new_loc);
-    interpreter.setf(std::ios_base::fixed, std::ios_base::floatfield);
-    interpreter.precision(f.first);
-    std::string s;
+    char buffer[1 + comma_format_buffer_size];
     if(f.second)
         {
         d *= 100;
         }
-    interpreter << d;
-    interpreter >> s;
-    if(!interpreter.eof())
-        {
-        alarum() << "Formatting error." << LMI_FLUSH;
-        }
-
+    std::size_t n = format_with_commas(buffer, comma_format_buffer_size, d, f.first);
     if(f.second)
         {
-        s += '%';
+        buffer[n++] = '%';
         }
-
-    return s;
+    return std::string(buffer, n);
 }
 
 std::vector<std::string> ledger_format
-    (std::vector<double>               dv
+    (std::vector<double> const&        dv
     ,std::pair<int,oenum_format_style> f
     )
 {
     std::vector<std::string> sv;
+    sv.reserve(dv.size());
     for(auto const& i : dv)
         {
         sv.push_back(ledger_format(i, f));
@@ -287,9 +287,10 @@ void LedgerVariant::set_run_basis(mcenum_run_basis b)
 LedgerVariant& LedgerVariant::PlusEq
     (LedgerVariant const&      a_Addend
     ,std::vector<double> const& a_Inforce
+    ,LedgerVariant*            a_Error
     )
 {
-    LedgerBase::PlusEq(a_Addend, a_Inforce);
+    LedgerBase::PlusEq(a_Addend, a_Inforce, a_Error);
 
     // Make sure total (this) has enough years to add all years of a_Addend to.
     LMI_ASSERT(a_Addend.Length <= Length);
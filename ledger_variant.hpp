@@ -55,6 +55,7 @@ class LMI_SO LedgerVariant
     LedgerVariant& PlusEq
         (LedgerVariant const&  a_Addend
         ,std::vector<double> const& a_Inforce
+        ,LedgerVariant*        a_Error = nullptr
         );
 
     void Init(BasicValues const&, mcenum_gen_basis, mcenum_sep_basis);
@@ -49,6 +49,7 @@
 #include <xsltwrapp/xsltwrapp.h>
 
 #include <algorithm>                    // std::transform()
+#include <cstddef>                      // std::size_t
 #include <functional>                   // std::minus
 #include <map>
 #include <ostream>
@@ -134,9 +135,13 @@ bool format_exists
         }
 }
 
-} // Unnamed namespace.
+/// Column titles for the supplemental report, keyed by column name.
+///
+/// Called only once: Ledger::write_values() keeps the result in a
+/// static object, instead of rebuilding hundreds of strings for each
+/// ledger written.
 
-void Ledger::write(xml::element& x) const
+title_map_t make_title_map()
 {
     title_map_t title_map;
 
@@ -292,6 +297,21 @@ void Ledger::write(xml::element& x) const
     // written in 2006-07. DATABASE !! So consider adding them there
     // when the database is revamped.
 
+    // Titles of derived columns: see Ledger::write_values().
+    title_map["NetDeathBenefit"] = " _____________ __Net __Death Benefit";
+    title_map["SupplDeathBft_Current"   ] = " _____________ Curr Suppl Death Benefit";
+    title_map["SupplDeathBft_Guaranteed"] = " _____________ Guar Suppl Death Benefit";
+    title_map["SupplSpecAmt"            ] = " _____________ Suppl Specified Amount";
+
+    return title_map;
+}
+
+/// Formats of numeric ledger values, keyed by name.
+///
+/// Called only once, like make_title_map().
+
+format_map_t make_format_map()
+{
 // Here's my top-level analysis of the formatting specification.
 //
 // Formats
@@ -540,6 +560,107 @@ void Ledger::write(xml::element& x) const
     format_map["TgtPrem"                           ] = f1;
     format_map["TotalLoanBalance"                  ] = f1;
 
+    // Formats of derived columns: see Ledger::write_values().
+    format_map["NetDeathBenefit"] = f1;
+    format_map["SupplDeathBft_Current"   ] = f1;
+    format_map["SupplDeathBft_Guaranteed"] = f1;
+    format_map["SupplSpecAmt"            ] = f1;
+
+    return format_map;
+}
+
+/// Title of the named column, or an empty string if it has none.
+
+std::string const& column_title(title_map_t const& m, std::string const& name)
+{
+    static std::string const none;
+    title_map_t::const_iterator i = m.find(name);
+    return m.end() == i ? none : i->second;
+}
+
+/// Append text to an xml buffer, escaped exactly as libxml2 escapes
+/// element content when serializing a document that declares no
+/// encoding: markup characters and carriage returns are replaced by
+/// entities, and non-ASCII characters by hexadecimal character
+/// references.
+///
+/// Valid UTF-8 is assumed; an invalid byte is written as a character
+/// reference to itself.
+
+void append_escaped(std::string& buffer, std::string const& s, bool attribute)
+{
+    static char const hex_digits[] = "0123456789ABCDEF";
+    std::size_t const n = s.size();
+    for(std::size_t j = 0; j < n; ++j)
+        {
+        unsigned char const c = static_cast<unsigned char>(s[j]);
+        switch(c)
+            {
+            case '&':  {buffer += "&amp;";                     } break;
+            case '<':  {buffer += "&lt;";                      } break;
+            case '>':  {buffer += "&gt;";                      } break;
+            case '"':  {buffer += attribute ? "&quot;" : "\""; } break;
+            case '\t': {buffer += attribute ? "&#9;"   : "\t";  } break;
+            case '\n': {buffer += attribute ? "&#10;"  : "\n";  } break;
+            case '\r': {buffer += attribute ? "&#13;"  : "&#xD;";} break;
+            default:
+                {
+                if(c < 0x80)
+                    {
+                    buffer += static_cast<char>(c);
+                    break;
+                    }
+                // Decode one UTF-8 sequence.
+                unsigned int code = c;
+                std::size_t length = 1;
+                if     (0xC0 == (c & 0xE0)) {code = c & 0x1F; length = 2;}
+                else if(0xE0 == (c & 0xF0)) {code = c & 0x0F; length = 3;}
+                else if(0xF0 == (c & 0xF8)) {code = c & 0x07; length = 4;}
+                if(1 < length && j + length <= n)
+                    {
+                    for(std::size_t k = 1; k < length; ++k)
+                        {
+                        code = (code << 6) | (static_cast<unsigned char>(s[j + k]) & 0x3F);
+                        }
+                    j += length - 1;
+                    }
+                else
+                    {
+                    code = c;
+                    }
+                char digits[8];
+                int d = 0;
+                do
+                    {
+                    digits[d++] = hex_digits[code & 0xF];
+                    code >>= 4;
+                    }
+                while(0 != code);
+                buffer += "&#x";
+                while(0 < d)
+                    {
+                    buffer += digits[--d];
+                    }
+                buffer += ';';
+                }
+            }
+        }
+}
+
+} // Unnamed namespace.
+
+/// Format ledger values as strings, for writing as xml.
+///
+/// The write() overloads emit exactly the data assembled here.
+
+void Ledger::write_values
+    (std::map<std::string,std::string>&              stringscalars
+    ,std::map<std::string,std::vector<std::string>>& stringvectors
+    ,std::vector<std::string>&                       supplemental_columns
+    ) const
+{
+    static format_map_t const format_map = make_format_map();
+
     // This is a little tricky. We have some stuff that
     // isn't in the maps inside the ledger classes. We're going to
     // stuff it into a copy of the invariant-ledger class's data.
@@ -627,22 +748,14 @@ void Ledger::write(xml::element& x) const
         ,std::minus<double>()
         );
     vectors   ["NetDeathBenefit"] = &NetDeathBenefit;
-    title_map ["NetDeathBenefit"] = " _____________ __Net __Death Benefit";
-    format_map["NetDeathBenefit"] = f1;
 
     std::vector<double> SupplDeathBft_Current   (Curr_.TermPurchased);
     std::vector<double> SupplDeathBft_Guaranteed(Guar_.TermPurchased);
     vectors   ["SupplDeathBft_Current"   ] = &SupplDeathBft_Current;
     vectors   ["SupplDeathBft_Guaranteed"] = &SupplDeathBft_Guaranteed;
-    title_map ["SupplDeathBft_Current"   ] = " _____________ Curr Suppl Death Benefit";
-    title_map ["SupplDeathBft_Guaranteed"] = " _____________ Guar Suppl Death Benefit";
-    format_map["SupplDeathBft_Current"   ] = f1;
-    format_map["SupplDeathBft_Guaranteed"] = f1;
 
     std::vector<double> SupplSpecAmt(Invar.TermSpecAmt);
     vectors   ["SupplSpecAmt"            ] = &SupplSpecAmt;
-    title_map ["SupplSpecAmt"            ] = " _____________ Suppl Specified Amount";
-    format_map["SupplSpecAmt"            ] = f1;
 
     // [End of derived columns.]
 
@@ -701,10 +814,11 @@ void Ledger::write(xml::element& x) const
         ;
     scalars["InitTotalSA"] = &InitTotalSA;
 
-    // Maps to hold the results of formatting numeric data.
+    // Maps (arguments) hold the results of formatting numeric data.
 
-    std::map<std::string, std::string> stringscalars;
-    std::map<std::string, std::vector<std::string>> stringvectors;
+    stringscalars.clear();
+    stringvectors.clear();
+    supplemental_columns.clear();
 
     stringvectors["FundNames"] = ledger_invariant_->FundNames;
 
@@ -717,7 +831,7 @@ void Ledger::write(xml::element& x) const
     for(auto const& j : scalars)
         {
         if(format_exists(j.first, suffix, format_map))
-            stringscalars[j.first + suffix] = ledger_format(*j.second, format_map[j.first]);
+            stringscalars[j.first + suffix] = ledger_format(*j.second, format_map.at(j.first));
         }
     for(auto const& j : strings)
         {
@@ -726,7 +840,7 @@ void Ledger::write(xml::element& x) const
     for(auto const& j : vectors)
         {
         if(format_exists(j.first, suffix, format_map))
-            stringvectors[j.first + suffix] = ledger_format(*j.second, format_map[j.first]);
+            stringvectors[j.first + suffix] = ledger_format(*j.second, format_map.at(j.first));
         }
     }
 
@@ -743,7 +857,7 @@ void Ledger::write(xml::element& x) const
             {
 //            scalars[j.first + suffix] = j.second;
             if(format_exists(j.first, suffix, format_map))
-                stringscalars[j.first + suffix] = ledger_format(*j.second, format_map[j.first]);
+                stringscalars[j.first + suffix] = ledger_format(*j.second, format_map.at(j.first));
             }
         for(auto const& j : i.second.Strings)
             {
@@ -753,7 +867,7 @@ void Ledger::write(xml::element& x) const
             {
 //            vectors[j.first + suffix] = j.second;
             if(format_exists(j.first, suffix, format_map))
-                stringvectors[j.first + suffix] = ledger_format(*j.second, format_map[j.first]);
+                stringvectors[j.first + suffix] = ledger_format(*j.second, format_map.at(j.first));
             }
         }
 
@@ -791,6 +905,72 @@ void Ledger::write(xml::element& x) const
 //    mcenum_sep_basis SepBasis_;
 //    bool             FullyInitialized;   // I.e. by Init(BasicValues const* b)
 
+    if(ledger_invariant_->SupplementalReport)
+        {
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn00);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn01);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn02);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn03);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn04);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn05);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn06);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn07);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn08);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn09);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn10);
+        supplemental_columns.push_back(ledger_invariant_->SupplementalReportColumn11);
+        }
+
+    if(is_composite() && contains(global_settings::instance().pyx(), "values_tsv"))
+        {
+        throw_if_interdicted(*this);
+
+        configurable_settings const& z = configurable_settings::instance();
+        fs::path filepath
+            (   z.print_directory()
+            +   "/values"
+            +   z.spreadsheet_file_extension()
+            );
+        fs::ofstream ofs(filepath, ios_out_trunc_binary());
+
+        for(auto const& j : stringvectors)
+            {
+            ofs << j.first << '\t';
+            }
+        ofs << '\n';
+
+        for(unsigned int i = 0; i < static_cast<unsigned int>(GetMaxLength()); ++i)
+            {
+            for(auto const& j : stringvectors)
+                {
+                std::vector<std::string> const& v = j.second;
+                if(i < v.size())
+                    {
+                    ofs << v[i] << '\t';
+                    }
+                else
+                    {
+                    ofs << '\t';
+                    }
+                }
+            ofs << '\n';
+            }
+        if(!ofs)
+            {
+            alarum() << "Unable to write '" << filepath << "'." << LMI_FLUSH;
+            }
+        }
+}
+
+void Ledger::write(xml::element& x) const
+{
+    static title_map_t const title_map = make_title_map();
+
+    std::map<std::string, std::string> stringscalars;
+    std::map<std::string, std::vector<std::string>> stringvectors;
+    std::vector<std::string> SupplementalReportColumns;
+    write_values(stringscalars, stringvectors, SupplementalReportColumns);
+
 // Now we're ready to write the xml.
 
     xml::element scalar("scalar");
@@ -821,23 +1001,6 @@ void Ledger::write(xml::element& x) const
         data.push_back(newcolumn);
         }
 
-    std::vector<std::string> SupplementalReportColumns;
-    if(ledger_invariant_->SupplementalReport)
-        {
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn00);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn01);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn02);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn03);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn04);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn05);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn06);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn07);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn08);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn09);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn10);
-        SupplementalReportColumns.push_back(ledger_invariant_->SupplementalReportColumn11);
-        }
-
     xml::element supplementalreport("supplementalreport");
     if(ledger_invariant_->SupplementalReport)
         {
@@ -848,7 +1011,7 @@ void Ledger::write(xml::element& x) const
             {
             xml::element columns("columns");
             columns.push_back(xml::element("name", j.c_str()));
-            columns.push_back(xml::element("title", title_map[j].c_str()));
+            columns.push_back(xml::element("title", column_title(title_map, j).c_str()));
             supplementalreport.push_back(columns);
             }
         }
@@ -874,46 +1037,6 @@ void Ledger::write(xml::element& x) const
     x.push_back(scalar);
     x.push_back(data);
     x.push_back(supplementalreport);
-
-    if(is_composite() && contains(global_settings::instance().pyx(), "values_tsv"))
-        {
-        throw_if_interdicted(*this);
-
-        configurable_settings const& z = configurable_settings::instance();
-        fs::path filepath
-            (   z.print_directory()
-            +   "/values"
-            +   z.spreadsheet_file_extension()
-            );
-        fs::ofstream ofs(filepath, ios_out_trunc_binary());
-
-        for(auto const& j : stringvectors)
-            {
-            ofs << j.first << '\t';
-            }
-        ofs << '\n';
-
-        for(unsigned int i = 0; i < static_cast<unsigned int>(GetMaxLength()); ++i)
-            {
-            for(auto const& j : stringvectors)
-                {
-                std::vector<std::string> const& v = j.second;
-                if(i < v.size())
-                    {
-                    ofs << v[i] << '\t';
-                    }
-                else
-                    {
-                    ofs << '\t';
-                    }
-                }
-            ofs << '\n';
-            }
-        if(!ofs)
-            {
-            alarum() << "Unable to write '" << filepath << "'." << LMI_FLUSH;
-            }
-        }
 }
 
 int Ledger::class_version() const
@@ -927,12 +1050,100 @@ std::string const& Ledger::xml_root_name() const
     return s;
 }
 
+/// Write the ledger as xml, without constructing a DOM.
+///
+/// The document has the same elements, in the same order, as the DOM
+/// built by write(xml::element&), with libxml2's indentation and
+/// escaping rules. Unlike the former implementation, which wrote that
+/// DOM's root node with 'os << root', this writes a complete document:
+/// it begins with an xml declaration and ends with a newline. The
+/// unit test pins these bytes. The text is assembled in a buffer that
+/// is reserved once and written in a single operation, so this is
+/// much faster than creating a node for every duration of every
+/// column.
+
 void Ledger::write(std::ostream& os) const
 {
-    xml_lmi::xml_document document(xml_root_name());
-    xml::element& root = document.root_node();
-    write(root);
-    os << root;
+    static title_map_t const title_map = make_title_map();
+
+    std::map<std::string, std::string> stringscalars;
+    std::map<std::string, std::vector<std::string>> stringvectors;
+    std::vector<std::string> SupplementalReportColumns;
+    write_values(stringscalars, stringvectors, SupplementalReportColumns);
+
+    std::string const& root = xml_root_name();
+
+    std::string buffer;
+    buffer.reserve(1024 * (1 + stringvectors.size()));
+
+    buffer += "<?xml version=\"1.0\"?>\n<";
+    buffer += root;
+    buffer += ">\n";
+
+    buffer += stringscalars.empty() ? "  <scalar/>\n" : "  <scalar>\n";
+    for(auto const& j : stringscalars)
+        {
+        buffer += "    <";
+        buffer += j.first;
+        buffer += '>';
+        append_escaped(buffer, j.second, false);
+        buffer += "</";
+        buffer += j.first;
+        buffer += ">\n";
+        }
+    buffer += stringscalars.empty() ? "" : "  </scalar>\n";
+
+    buffer += stringvectors.empty() ? "  <data/>\n" : "  <data>\n";
+    for(auto const& j : stringvectors)
+        {
+        std::vector<std::string> const& v = j.second;
+        buffer += "    <newcolumn>\n      <column name=\"";
+        append_escaped(buffer, j.first, true);
+        if(v.empty())
+            {
+            buffer += "\"/>\n";
+            }
+        else
+            {
+            buffer += "\">\n";
+            for(std::size_t k = 0; k < v.size(); ++k)
+                {
+                buffer += "        <duration number=\"";
+                buffer += value_cast<std::string>(k);
+                buffer += "\" column_value=\"";
+                append_escaped(buffer, v[k], true);
+                buffer += "\"/>\n";
+                }
+            buffer += "      </column>\n";
+            }
+        buffer += "    </newcolumn>\n";
+        }
+    buffer += stringvectors.empty() ? "" : "  </data>\n";
+
+    if(ledger_invariant_->SupplementalReport)
+        {
+        buffer += "  <supplementalreport>\n";
+        buffer += "    <title>Supplemental Report</title>\n";
+        for(auto const& j : SupplementalReportColumns)
+            {
+            buffer += "    <columns>\n      <name>";
+            append_escaped(buffer, j, false);
+            buffer += "</name>\n      <title>";
+            append_escaped(buffer, column_title(title_map, j), false);
+            buffer += "</title>\n    </columns>\n";
+            }
+        buffer += "  </supplementalreport>\n";
+        }
+    else
+        {
+        buffer += "  <supplementalreport/>\n";
+        }
+
+    buffer += "</";
+    buffer += root;
+    buffer += ">\n";
+
+    os.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
 }
 
 /// Write a scaled copy of the ledger as xsl-fo.
@@ -0,0 +1,121 @@
+// Ledger xml input and output--unit test.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "ledger.hpp"
+
+#include "calendar_date.hpp"
+#include "contains.hpp"
+#include "global_settings.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "miscellany.hpp"               // begins_with(), ends_with()
+#include "test_tools.hpp"
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+/// A ledger with two durations, whose producer name contains every
+/// character that xml escapes in text.
+
+Ledger sample_ledger()
+{
+    int const length = 2;
+    Ledger z(length, mce_ill_reg, false, false, false);
+
+    LedgerInvariant invariant(length);
+    invariant.Age          = 45;
+    invariant.EndtAge      = 45 + length;
+    invariant.IsInforce    = true;
+    invariant.EffDateJdn   = calendar_date(2017, 1, 1).julian_day_number();
+    invariant.ProducerName = "A & B <C> \"D\"";
+    z.SetLedgerInvariant(invariant);
+
+    for(auto const& basis : z.GetRunBases())
+        {
+        LedgerVariant variant(length);
+        variant.set_run_basis(basis);
+        variant.LapseYear = length;
+        z.SetOneLedgerVariant(basis, variant);
+        }
+    return z;
+}
+} // Unnamed namespace.
+
+/// Pin the bytes that Ledger::write(std::ostream&) writes.
+///
+/// The output begins with an xml declaration and ends with a newline;
+/// elements are indented by two spaces per level; empty scalars are
+/// written with start and end tags; and durations are written as
+/// empty elements with attributes.
+
+void test_write()
+{
+    std::ostringstream oss;
+    sample_ledger().write(oss);
+    std::string const s = oss.str();
+
+    BOOST_TEST
+        (begins_with
+            (s
+            ,"<?xml version=\"1.0\"?>\n"
+             "<illustration>\n"
+             "  <scalar>\n"
+             "    <ADDFootnote></ADDFootnote>\n"
+            )
+        );
+    BOOST_TEST
+        (ends_with
+            (s
+            ,"  </data>\n"
+             "  <supplementalreport/>\n"
+             "</illustration>\n"
+            )
+        );
+    BOOST_TEST_EQUAL(std::string::npos, s.find("<?xml", 1));
+
+    BOOST_TEST(contains
+        (s
+        ,"    <ProducerName>A &amp; B &lt;C&gt; \"D\"</ProducerName>\n"
+        ));
+    BOOST_TEST(contains
+        (s
+        ,"    <newcolumn>\n"
+         "      <column name=\"PolicyYear\">\n"
+         "        <duration number=\"0\" column_value=\"1\"/>\n"
+         "        <duration number=\"1\" column_value=\"2\"/>\n"
+         "      </column>\n"
+         "    </newcolumn>\n"
+        ));
+}
+
+int test_main(int, char*[])
+{
+    // Use the ledger's effective date as the date prepared, and
+    // avoid authentication.
+    global_settings::instance().set_regression_testing(true);
+
+    test_write();
+    return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 
 #include "account_value.hpp"
 #include "assert_lmi.hpp"
+#include "emit_ledger.hpp"              // run_bases_required()
 #include "fenv_guard.hpp"
 #include "input.hpp"
 #include "ledger.hpp"
@@ -34,11 +35,15 @@ IllusVal::IllusVal(std::string const& filename)
 {
 }
 
-double IllusVal::run(Input const& input)
+/// Run an illustration, calculating only the bases that 'emission'
+/// requires--by default, all bases.
+
+double IllusVal::run(Input const& input, mcenum_emission emission)
 {
     fenv_guard fg;
     AccountValue av(input);
     av.SetDebugFilename(filename_);
+    av.RestrictRunBases(run_bases_required(emission));
 
     double z = av.RunAV();
     ledger_ = av.ledger_from_av();
@@ -24,6 +24,7 @@
 
 #include "config.hpp"
 
+#include "mc_enum_type_enums.hpp"       // enum mcenum_emission
 #include "so_attributes.hpp"
 
 #include <memory>                       // std::shared_ptr
@@ -42,7 +43,7 @@ class IllusVal final
     explicit IllusVal(std::string const& filename);
     ~IllusVal() = default;
 
-    double run(Input const&);
+    double run(Input const&, mcenum_emission = mce_emit_nothing);
 
     std::shared_ptr<Ledger const> ledger() const;
 
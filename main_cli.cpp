@@ -23,11 +23,17 @@
 
 #include "alert.hpp"
 #include "assert_lmi.hpp"
+#include "census_import.hpp"
+#include "census_validation.hpp"        // default_number_of_threads()
+#include "configurable_settings.hpp"
 #include "contains.hpp"
 #include "dbdict.hpp"                   // print_databases()
+#include "delta_census.hpp"
+#include "emit_ledger.hpp"
 #include "getopt.hpp"
 #include "global_settings.hpp"
 #include "gpt_server.hpp"
+#include "gzip_stream.hpp"              // has_gzip_extension()
 #include "illustrator.hpp"
 #include "input.hpp"
 #include "ledger.hpp"
@@ -40,13 +46,17 @@
 #include "mc_enum_types.hpp"
 #include "mc_enum_types_aux.hpp"        // allowed_strings_emission(), mc_emission_from_string()
 #include "mec_server.hpp"
-#include "miscellany.hpp"
-#include "path_utility.hpp"
+#include "miscellany.hpp"               // ios_out_trunc_binary()
+#include "multiple_cell_document.hpp"
+#include "path_utility.hpp"             // unique_filepath()
+#include "scenario_values.hpp"
+#include "single_cell_document.hpp"
 #include "so_attributes.hpp"
 #include "timer.hpp"
 #include "value_cast.hpp"
 
 #include <boost/filesystem/convenience.hpp>
+#include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/path.hpp>
 
 #include <algorithm>
@@ -141,6 +151,212 @@ void self_test()
         ;
 }
 
+/// Emit each '.ledger' file written earlier with 'emit_binary_ledger'.
+///
+/// This reproduces any other output from saved results without
+/// running the calculations again.
+
+void emit_binary_ledgers
+    (std::vector<std::string> const& ledger_filenames
+    ,mcenum_emission                 emission
+    )
+{
+    for(auto const& i : ledger_filenames)
+        {
+        fs::ifstream ifs(i, std::ios_base::in | std::ios_base::binary);
+        if(!ifs)
+            {
+            alarum() << "Unable to open ledger file '" << i << "'." << LMI_FLUSH;
+            }
+        Timer timer;
+        Ledger ledger(1, mce_ill_reg, false, false, false);
+        ledger.read_binary(ifs, i);
+        double const seconds_for_input = timer.stop().elapsed_seconds();
+        double const seconds_for_output = emit_ledger(fs::path(i), ledger, emission);
+        if(emission & mce_emit_timings)
+            {
+            std::cout
+                << "\n    Input:        "
+                << Timer::elapsed_msec_str(seconds_for_input)
+                << "\n    Output:       "
+                << Timer::elapsed_msec_str(seconds_for_output)
+                << '\n'
+                ;
+            }
+        }
+}
+
+namespace
+{
+/// A '.csv' file is comma-delimited; any other census file is
+/// tab-delimited.
+
+char census_delimiter(std::string const& filename)
+{
+    return ".csv" == fs::extension(filename) ? ',' : '\t';
+}
+
+void open_census_file(fs::ifstream& ifs, std::string const& filename)
+{
+    ifs.open(filename, std::ios_base::in | std::ios_base::binary);
+    if(!ifs)
+        {
+        alarum()
+            << "Unable to open census file '"
+            << filename
+            << "'."
+            << LMI_FLUSH
+            ;
+        }
+}
+
+void show_import_timing
+    (mcenum_emission emission
+    ,int             number_of_cells
+    ,double          seconds
+    )
+{
+    if(emission & mce_emit_timings)
+        {
+        std::cout
+            << "\n    Import:       "
+            << number_of_cells
+            << " cells in "
+            << Timer::elapsed_msec_str(seconds)
+            << '\n'
+            ;
+        }
+}
+} // Unnamed namespace.
+
+/// Convert each delimited census file to a '.cns' file.
+///
+/// The first line of each file names input fields, and each later
+/// line is one cell; see class census_importer. Cells are encoded as
+/// they are read, so a very large census is never held in memory as
+/// complete Input objects.
+
+void import_censuses
+    (std::vector<std::string> const& census_filenames
+    ,mcenum_emission                 emission
+    )
+{
+    for(auto const& i : census_filenames)
+        {
+        Timer timer;
+        fs::ifstream ifs;
+        open_census_file(ifs, i);
+        census_importer importer(ifs, default_cell(), census_delimiter(i));
+        delta_census census
+            (importer.exemplar()
+            ,std::vector<Input>(1, importer.exemplar())
+            );
+        importer.import_cells
+            ([&census] (Input const& cell) {census.push_back(cell);}
+            ,default_number_of_threads()
+            );
+        if(census.empty())
+            {
+            warning() << "'" << i << "': no cells to import." << LMI_FLUSH;
+            continue;
+            }
+        fs::ofstream ofs
+            (fs::change_extension(fs::path(i), ".cns")
+            ,ios_out_trunc_binary()
+            );
+        multiple_cell_document::write(ofs, census);
+        show_import_timing(emission, census.size(), timer.stop().elapsed_seconds());
+        }
+}
+
+/// Run each delimited census file as though it were a '.cns' file.
+
+void run_imported_censuses
+    (std::vector<std::string> const& census_filenames
+    ,mcenum_emission                 emission
+    )
+{
+    for(auto const& i : census_filenames)
+        {
+        Timer timer;
+        fs::ifstream ifs;
+        open_census_file(ifs, i);
+        census_importer importer(ifs, default_cell(), census_delimiter(i));
+        std::vector<Input> cells;
+        importer.import_cells
+            ([&cells] (Input const& cell) {cells.push_back(cell);}
+            ,default_number_of_threads()
+            );
+        if(cells.empty())
+            {
+            warning() << "'" << i << "': no cells to run." << LMI_FLUSH;
+            continue;
+            }
+        test_census_consensus(emission, importer.exemplar(), cells);
+        show_import_timing(emission, static_cast<int>(cells.size()), timer.stop().elapsed_seconds());
+        illustrator z(emission);
+        z(fs::path(i), cells);
+        }
+}
+
+/// Run each '.ill' file under the scenarios in a specification file.
+///
+/// For each input file, write a tab-delimited matrix of the specified
+/// columns by duration and scenario, in lieu of ordinary output.
+
+void run_scenarios
+    (std::string              const& specification_filename
+    ,std::vector<std::string> const& input_filenames
+    ,mcenum_emission                 emission
+    )
+{
+    fs::ifstream ifs(specification_filename);
+    if(!ifs)
+        {
+        alarum()
+            << "Unable to open scenario file '"
+            << specification_filename
+            << "'."
+            << LMI_FLUSH
+            ;
+        }
+    scenario_specification const specification =
+        read_scenario_specification(ifs);
+
+    std::string const& tsv_ext =
+        configurable_settings::instance().spreadsheet_file_extension();
+    for(auto const& i : input_filenames)
+        {
+        if(".ill" != fs::extension(i))
+            {
+            warning()
+                << "'"
+                << i
+                << "': scenarios can be run only for '.ill' files."
+                << LMI_FLUSH
+                ;
+            continue;
+            }
+        Input const input = single_cell_document(i).input_data();
+        scenario_values const z(i, input, specification);
+        fs::ofstream ofs
+            (unique_filepath(fs::path(i), ".scenarios" + tsv_ext)
+            ,ios_out_trunc_binary()
+            );
+        z.write_matrix(ofs);
+        if(emission & mce_emit_timings)
+            {
+            std::cout
+                << "    Scenarios: "
+                << z.ledgers().size()
+                << " in "
+                << Timer::elapsed_msec_str(z.seconds_for_calculations())
+                << std::endl
+                ;
+            }
+        }
+}
+
 /// Run self-test repeatedly (intended for use with 'gprof').
 
 void profile()
@@ -168,8 +384,10 @@ void process_command_line(int argc, char* argv[])
         {"profile"   ,NO_ARG   ,0 ,'o' ,0 ,"set up for profiling and exit"},
         {"emit"      ,REQD_ARG ,0 ,'e' ,0 ,"choose what output to emit"},
         {"file"      ,REQD_ARG ,0 ,'f' ,0 ,"input file to run"},
+        {"import"    ,REQD_ARG ,0 ,'i' ,0 ,"write '.cns' file from '.tsv' or '.csv' census"},
         {"data_path" ,REQD_ARG ,0 ,'d' ,0 ,"path to data files"},
         {"print_db"  ,NO_ARG   ,0 ,'p' ,0 ,"print product databases and exit"},
+        {"scenarios" ,REQD_ARG ,0 ,'c' ,0 ,"run '.ill' files under scenarios in file"},
         {0           ,NO_ARG   ,0 ,0   ,0 ,""}
       };
 
@@ -183,8 +401,13 @@ void process_command_line(int argc, char* argv[])
     mcenum_emission emission(mce_emit_nothing);
 
     std::vector<std::string> illustrator_names;
+    std::vector<std::string> census_names;
+    std::vector<std::string> import_names;
     std::vector<std::string> mec_server_names;
     std::vector<std::string> gpt_server_names;
+    std::vector<std::string> ledger_names;
+
+    std::string scenario_filename;
 
     int digit_optind = 0;
     int this_option_optind = 1;
@@ -259,6 +482,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'c':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                scenario_filename = getopt_long.optarg;
+                }
+                break;
+
             case 'd':
                 {
                 global_settings::instance().set_data_directory
@@ -303,11 +533,21 @@ void process_command_line(int argc, char* argv[])
                 {
                 LMI_ASSERT(nullptr != getopt_long.optarg);
                 std::string const s(getopt_long.optarg);
-                std::string const e = fs::extension(s);
-                if(".cns" == e || ".ill" == e || ".ini" == e || ".inix" == e)
+                // A compressed file, e.g. 'x.cns.gz', is passed to the
+                // illustrator, which accepts compressed '.cns' and '.ill'
+                // files and diagnoses any other compressed type.
+                bool const gz = has_gzip_extension(s);
+                std::string const e = fs::extension
+                    (gz ? fs::change_extension(s, "") : fs::path(s)
+                    );
+                if(gz || ".cns" == e || ".ill" == e || ".ini" == e || ".inix" == e)
                     {
                     illustrator_names.push_back(getopt_long.optarg);
                     }
+                else if(".tsv" == e || ".csv" == e)
+                    {
+                    census_names.push_back(getopt_long.optarg);
+                    }
                 else if(".mec" == e)
                     {
                     mec_server_names.push_back(getopt_long.optarg);
@@ -316,6 +556,10 @@ void process_command_line(int argc, char* argv[])
                     {
                     gpt_server_names.push_back(getopt_long.optarg);
                     }
+                else if(".ledger" == e)
+                    {
+                    ledger_names.push_back(getopt_long.optarg);
+                    }
                 else
                     {
                     warning()
@@ -334,6 +578,13 @@ void process_command_line(int argc, char* argv[])
                 }
                 break;
 
+            case 'i':
+                {
+                LMI_ASSERT(nullptr != getopt_long.optarg);
+                import_names.push_back(getopt_long.optarg);
+                }
+                break;
+
             case 'l':
                 {
                 show_license = true;
@@ -430,12 +681,22 @@ void process_command_line(int argc, char* argv[])
         return;
         }
 
+    if(!scenario_filename.empty())
+        {
+        run_scenarios(scenario_filename, illustrator_names, emission);
+        return;
+        }
+
+    import_censuses(import_names, emission);
+
     std::for_each
         (illustrator_names.begin()
         ,illustrator_names.end()
         ,illustrator(emission)
         );
 
+    run_imported_censuses(census_names, emission);
+
     std::for_each
         (mec_server_names.begin()
         ,mec_server_names.end()
@@ -447,11 +708,16 @@ void process_command_line(int argc, char* argv[])
         ,gpt_server_names.end()
         ,gpt_server(emission)
         );
+
+    emit_binary_ledgers(ledger_names, emission);
 }
 
 int try_main(int argc, char* argv[])
 {
     initialize_filesystem();
+    // This program's implementations of alert, system_command, and
+    // file_command may be called from any thread.
+    permit_asynchronous_emission(true);
     process_command_line(argc, argv);
     return EXIT_SUCCESS;
 }
@@ -25,6 +25,7 @@
 #include "config.hpp"
 
 #include "datum_base.hpp"
+#include "stream_cast.hpp"
 
 #include <boost/operators.hpp>
 
@@ -102,6 +103,7 @@ class mc_enum
 
     friend class mc_enum_test;
     template<typename U> friend std::vector<std::string> const& all_strings();
+    template<typename U> friend mc_enum<U> value_cast(std::string const&, mc_enum<U>);
 
   public:
     typedef T enum_type;
@@ -134,6 +136,9 @@ class mc_enum
     static T    const*        e();
     static char const* const* c();
     static std::vector<std::string> const& s();
+    static std::size_t index_of(std::string const&);
+
+    void assign_extracted(std::string const&);
 
     // datum_base required implementation.
     std::istream& read (std::istream&) override;
@@ -148,5 +153,23 @@ std::vector<std::string> const& all_strings()
     return mc_enum<U>::s();
 }
 
+/// Convert a string to an mc_enum without a std::stringstream.
+///
+/// See the corresponding overload for tn_range. Assigning a string
+/// that would have been extracted verbatim has the same effect as
+/// extracting it, including translation of obsolete strings.
+
+template<typename U>
+inline mc_enum<U> value_cast(std::string const& from, mc_enum<U>)
+{
+    if(!stream_extracts_verbatim(from))
+        {
+        return stream_cast<mc_enum<U>>(from);
+        }
+    mc_enum<U> z;
+    z.assign_extracted(from);
+    return z;
+}
+
 #endif // mc_enum_hpp
 
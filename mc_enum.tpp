@@ -23,11 +23,13 @@
 #include "mc_enum_metadata.hpp"
 
 #include "alert.hpp"
+#include "assert_lmi.hpp"
 #include "facets.hpp"
 #include "rtti_lmi.hpp"
 
 #include <algorithm>                    // std::find()
 #include <typeinfo>
+#include <unordered_map>
 
 /// The header that defines class mc_enum is by design unaware of its
 /// associated metadata, so static assertions that depend on metadata
@@ -89,7 +91,7 @@ bool mc_enum<T>::operator==(std::string const& s) const
 template<typename T>
 std::size_t mc_enum<T>::ordinal(std::string const& s)
 {
-    std::size_t v = std::find(c(), c() + n(), s) - c();
+    std::size_t v = index_of(s);
     if(v == n())
         {
         alarum()
@@ -131,9 +133,21 @@ void mc_enum<T>::enforce_proscription()
         }
 }
 
+/// Most enumerations are numbered consecutively from zero, so that
+/// each enumerator is its own ordinal; only in other cases is e()
+/// searched.
+
 template<typename T>
 std::size_t mc_enum<T>::ordinal() const
 {
+    // A negative enumerator converts to a large unsigned value, which
+    // fails the first test.
+    std::size_t const u = static_cast<std::size_t>(value_);
+    if(u < n() && value_ == e()[u])
+        {
+        return u;
+        }
+
     std::size_t i = std::find(e(), e() + n(), value_) - e();
     if(i == n())
         {
@@ -168,7 +182,8 @@ T mc_enum<T>::value() const
 }
 
 // TODO ?? Should there be a runtime check that all elements in
-// e() and in c() are unique? Can that be asserted at compile time?
+// e() are unique, as index_of() checks those in c()? Can that be
+// asserted at compile time?
 
 template<typename T>
 std::size_t        mc_enum<T>::n() {return mc_enum_key<T>::n_;}
@@ -186,6 +201,30 @@ std::vector<std::string> const& mc_enum<T>::s()
     return v;
 }
 
+/// Index of the given string in c(), or n() if it is not found.
+///
+/// Strings are looked up in a hash table built once for each type,
+/// instead of compared with each element of c() in turn. Building
+/// the table asserts that no string occurs twice.
+
+template<typename T>
+std::size_t mc_enum<T>::index_of(std::string const& s)
+{
+    typedef std::unordered_map<std::string,std::size_t> index_type;
+    static index_type const index = [] ()
+        {
+        index_type z(n());
+        for(std::size_t j = 0; j < n(); ++j)
+            {
+            bool const unique = z.insert({c()[j], j}).second;
+            LMI_ASSERT(unique);
+            }
+        return z;
+        } ();
+    auto const i = index.find(s);
+    return (index.end() == i) ? n() : i->second;
+}
+
 namespace
 {
 /// A whilom version of a vetust class substituted underbars for
@@ -219,10 +258,20 @@ std::istream& mc_enum<T>::read(std::istream& is)
     is >> s;
     is.imbue(old_locale);
 
-    std::size_t v = std::find(c(), c() + n(), s) - c();
+    assign_extracted(s);
+
+    return is;
+}
+
+/// Assign a string extracted by read(), translating it if obsolete.
+
+template<typename T>
+void mc_enum<T>::assign_extracted(std::string const& s)
+{
+    std::size_t v = index_of(s);
     if(n() == v)
         {
-        v = std::find(c(), c() + n(), provide_for_backward_compatibility(s)) - c();
+        v = index_of(provide_for_backward_compatibility(s));
         }
     if(n() == v)
         {
@@ -230,8 +279,6 @@ std::istream& mc_enum<T>::read(std::istream& is)
         throw "Unreachable.";
         }
     value_ = e()[v];
-
-    return is;
 }
 
 template<typename T>
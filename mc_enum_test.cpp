@@ -24,9 +24,13 @@
 #include "ce_product_name.hpp"
 #include "mc_enum.hpp"
 #include "mc_enum_test_aux.hpp"
+#include "mc_enum_types.hpp"
 
+#include "miscellany.hpp"               // stifle_warning_for_unused_variable()
 #include "test_tools.hpp"
+#include "timer.hpp"
 
+#include <algorithm>                    // std::find()
 #include <sstream>
 #include <stdexcept>
 
@@ -37,12 +41,16 @@ struct mc_enum_test
 {
     static void test();
     static void test_product_name();
+    static void test_large_enumeration();
+    static void assay_speed();
 };
 
 int test_main(int, char*[])
 {
     mc_enum_test::test();
     mc_enum_test::test_product_name();
+    mc_enum_test::test_large_enumeration();
+    mc_enum_test::assay_speed();
     return 0;
 }
 
@@ -237,3 +245,88 @@ void mc_enum_test::test_product_name()
         );
 }
 
+
+/// Test every string of a large enumeration, whose enumerators are
+/// numbered consecutively from zero.
+
+void mc_enum_test::test_large_enumeration()
+{
+    std::vector<std::string> const& v = all_strings<mcenum_state>();
+    BOOST_TEST_EQUAL(53, v.size());
+    mce_state state;
+    for(std::size_t j = 0; j < v.size(); ++j)
+        {
+        state = v[j];
+        BOOST_TEST_EQUAL(j, mce_state::ordinal(v[j]));
+        BOOST_TEST_EQUAL(j, state.ordinal());
+        BOOST_TEST_EQUAL(v[j], state.str());
+        }
+
+    // Enumerators that aren't consecutive from zero are found, too.
+    BOOST_TEST_EQUAL(2, e_island(i_Ni_ihau).ordinal());
+    BOOST_TEST_EQUAL(1, e_island::ordinal("Pago Pago"));
+
+    BOOST_TEST_THROW
+        (mce_state::ordinal("ZZ")
+        ,std::runtime_error
+        ,"Value 'ZZ' invalid for type 'mcenum_state'."
+        );
+}
+
+namespace
+{
+std::vector<std::string> const& state_strings()
+{
+    return all_strings<mcenum_state>();
+}
+
+/// Speed test: look up every state's string, by linear search.
+
+void mete_linear_search()
+{
+    std::vector<std::string> const& v = state_strings();
+    std::size_t volatile z = 0;
+    for(auto const& i : v)
+        {
+        z = std::find(v.begin(), v.end(), i) - v.begin();
+        }
+    stifle_warning_for_unused_variable(z);
+}
+
+/// Speed test: look up every state's string, by ordinal().
+
+void mete_ordinal()
+{
+    std::size_t volatile z = 0;
+    for(auto const& i : state_strings())
+        {
+        z = mce_state::ordinal(i);
+        }
+    stifle_warning_for_unused_variable(z);
+}
+
+/// Speed test: assign every state's string, and find its ordinal.
+
+void mete_assign()
+{
+    mce_state state;
+    std::size_t volatile z = 0;
+    for(auto const& i : state_strings())
+        {
+        state = i;
+        z = state.ordinal();
+        }
+    stifle_warning_for_unused_variable(z);
+}
+} // Unnamed namespace.
+
+void mc_enum_test::assay_speed()
+{
+    std::cout
+        << "\n  Speed tests (all 53 states):"
+        << "\n  linear search    : " << TimeAnAliquot(mete_linear_search)
+        << "\n  ordinal(string)  : " << TimeAnAliquot(mete_ordinal      )
+        << "\n  assign, ordinal(): " << TimeAnAliquot(mete_assign       )
+        << std::endl
+        ;
+}
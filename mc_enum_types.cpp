@@ -67,6 +67,8 @@ extern mcenum_emission const emission_enums[] =
     ,mce_emit_custom_0
     ,mce_emit_custom_1
     ,mce_emit_group_quote
+    ,mce_emit_binary_ledger
+    ,mce_emit_low_memory
     };
 extern char const*const emission_strings[] =
     {"emit_nothing"
@@ -83,9 +85,11 @@ extern char const*const emission_strings[] =
     ,"emit_custom_0"
     ,"emit_custom_1"
     ,"emit_group_quote"
+    ,"emit_binary_ledger"
+    ,"emit_low_memory"
     };
 template<> struct mc_enum_key<mcenum_emission>
-  :public mc_enum_data<mcenum_emission, 14, emission_enums, emission_strings> {};
+  :public mc_enum_data<mcenum_emission, 16, emission_enums, emission_strings> {};
 template class mc_enum<mcenum_emission>;
 
 extern rounding_style const rounding_style_enums[] =
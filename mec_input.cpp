@@ -38,6 +38,7 @@
 #include <algorithm>                    // std::max()
 #include <exception>
 #include <limits>
+#include <memory>                       // std::shared_ptr
 #include <sstream>
 #include <utility>                      // std::pair
 
@@ -54,7 +55,7 @@ std::string realize_sequence_string
 {
     try
         {
-        InputSequence s
+        std::shared_ptr<InputSequence const> const s = memoized_input_sequence
             (sequence_string.value()
             ,input.years_to_maturity()
             ,input.issue_age        ()
@@ -62,7 +63,7 @@ std::string realize_sequence_string
             ,input.inforce_year     ()
             ,input.effective_year   ()
             );
-        detail::convert_vector(v, s.seriatim_numbers());
+        detail::convert_vector(v, s->seriatim_numbers());
         }
     catch(std::exception const& e)
         {
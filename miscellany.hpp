@@ -149,6 +149,16 @@ inline std::ios_base::openmode ios_out_trunc_binary()
         ;
 }
 
+inline std::ios_base::openmode ios_in_out_trunc_binary()
+{
+    return
+          std::ios_base::in
+        | std::ios_base::out
+        | std::ios_base::trunc
+        | std::ios_base::binary
+        ;
+}
+
 /// 27.4.4.1/3
 
 inline std::ios::fmtflags set_default_format_flags(std::ios_base& stream)
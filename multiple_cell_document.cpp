@@ -26,6 +26,8 @@
 #include "alert.hpp"
 #include "assert_lmi.hpp"
 #include "data_directory.hpp"           // AddDataDir()
+#include "delta_census.hpp"
+#include "input_xml_reader.hpp"
 #include "value_cast.hpp"
 #include "xml_lmi.hpp"
 
@@ -36,9 +38,11 @@
 
 #include <iomanip>
 #include <istream>
+#include <memory>                       // std::unique_ptr
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
+#include <utility>                      // std::move()
 
 //============================================================================
 multiple_cell_document::multiple_cell_document()
@@ -52,8 +56,11 @@ multiple_cell_document::multiple_cell_document()
 //============================================================================
 multiple_cell_document::multiple_cell_document(std::string const& filename)
 {
-    xml_lmi::dom_parser parser(filename);
-    parse(parser);
+    if(!stream(filename, [this] (Input const& cell) {cell_parms_.push_back(cell);}))
+        {
+        xml_lmi::dom_parser parser(filename);
+        parse(parser);
+        }
     assert_vector_sizes_are_sane();
 }
 
@@ -109,16 +116,101 @@ T& hurl(std::string const& s)
 }
 } // Unnamed namespace.
 
+/// Read a file written by lmi without building a DOM, if possible.
+///
+/// Particular cells are passed to 'sink'; defaults are read into
+/// their vectors, as parse() does. Returns false, having read
+/// nothing, if the file must be parsed into a DOM instead.
+///
+/// read_input_cells() ensures that the three sections are present,
+/// in order; the number of cells in each is validated here, so that
+/// a malformed file is reported by name rather than by assertion.
+
+bool multiple_cell_document::stream
+    (std::string const& filename
+    ,cell_sink   const& sink
+    )
+{
+    static std::vector<std::string> const sections
+        {"case_default"
+        ,"class_defaults"
+        ,"particular_cells"
+        };
+
+    case_parms_ .clear();
+    class_parms_.clear();
+    cell_parms_ .clear();
+
+    Input cell;
+    int counter = 0;
+    int number_of_particular_cells = 0;
+    auto read_one = [&] (std::string const& parent)
+        {
+        if("particular_cells" == parent)
+            {
+            if(1 != case_parms_.size() || class_parms_.empty())
+                {
+                throw std::runtime_error
+                    ("Exactly one case default and at least one class default"
+                     " must precede the particular cells."
+                    );
+                }
+            ++number_of_particular_cells;
+            sink(cell);
+            }
+        else if("case_default" == parent)
+            {
+            if(!case_parms_.empty())
+                {
+                throw std::runtime_error("More than one case default.");
+                }
+            case_parms_.push_back(cell);
+            }
+        else
+            {
+            class_parms_.push_back(cell);
+            }
+        status() << "Read " << ++counter << " cells." << std::flush;
+        };
+    bool const okay = read_input_cells
+        (filename
+        ,xml_root_name()
+        ,class_version()
+        ,sections
+        ,cell
+        ,read_one
+        );
+    if(okay && 0 == number_of_particular_cells)
+        {
+        alarum() << "Census '" << filename << "' has no cells." << LMI_FLUSH;
+        }
+    return okay;
+}
+
 /// Read xml into vectors of class Input.
 
 void multiple_cell_document::parse(xml_lmi::dom_parser const& parser)
+{
+    parse(parser, [this] (Input const& cell) {cell_parms_.push_back(cell);});
+    assert_vector_sizes_are_sane();
+}
+
+/// Read xml, passing each particular cell to 'sink'.
+///
+/// Case and class defaults are read into their vectors before any
+/// particular cell is passed to 'sink', which may therefore use them.
+
+void multiple_cell_document::parse
+    (xml_lmi::dom_parser const& parser
+    ,cell_sink           const& sink
+    )
 {
     xml::element const& root(parser.root_node(xml_root_name()));
 
     int file_version = 0;
     if(!xml_lmi::get_attr(root, "version", file_version))
         {
-        parse_v0(parser);
+        parse_v0(parser, sink);
         return;
         }
 
@@ -143,13 +235,23 @@ void multiple_cell_document::parse(xml_lmi::dom_parser const& parser)
     for(auto const& i : root.elements())
         {
         std::string const tag(i.get_name());
+        xml::const_nodes_view const subelements(i.elements());
+        if("particular_cells" == tag)
+            {
+            LMI_ASSERT(1 == case_parms_.size());
+            for(auto const& j : subelements)
+                {
+                j >> cell;
+                sink(cell);
+                status() << "Read " << ++counter << " cells." << std::flush;
+                }
+            continue;
+            }
         std::vector<Input>& v
             ( ("case_default"     == tag) ? case_parms_
             : ("class_defaults"   == tag) ? class_parms_
-            : ("particular_cells" == tag) ? cell_parms_
             : hurl<std::vector<Input>>("Unexpected element '" + tag + "'.")
             );
-        xml::const_nodes_view const subelements(i.elements());
         v.reserve(subelements.size());
         for(auto const& j : subelements)
             {
@@ -158,13 +260,14 @@ void multiple_cell_document::parse(xml_lmi::dom_parser const& parser)
             status() << "Read " << ++counter << " cells." << std::flush;
             }
         }
-
-    assert_vector_sizes_are_sane();
 }
 
 /// Parse obsolete version 0 xml (for backward compatibility).
 
-void multiple_cell_document::parse_v0(xml_lmi::dom_parser const& parser)
+void multiple_cell_document::parse_v0
+    (xml_lmi::dom_parser const& parser
+    ,cell_sink           const& sink
+    )
 {
     xml::element const& root(parser.root_node(xml_root_name()));
 
@@ -308,31 +411,32 @@ void multiple_cell_document::parse_v0(xml_lmi::dom_parser const& parser)
 
     // Parameters for each cell.
     cell_parms_.clear();
-    cell_parms_.reserve(number_of_cells);
 
+    unsigned int cells_read = 0;
     ++i;
     for(; i != elements.end(); ++i)
         {
         *i >> temp;
-        cell_parms_.push_back(temp);
+        sink(temp);
+        ++cells_read;
         status()
             << "Read "
-            << cell_parms_.size()
+            << cells_read
             << " of "
             << number_of_cells
             << " lives."
             << std::flush
             ;
-        if(cell_parms_.size() == number_of_cells)
+        if(cells_read == number_of_cells)
             {
             break;
             }
         }
-    if(cell_parms_.size() != number_of_cells)
+    if(cells_read != number_of_cells)
         {
         alarum()
             << "Number of individuals read is "
-            << cell_parms_.size()
+            << cells_read
             << " but should have been "
             << number_of_cells
             << "."
@@ -350,8 +454,6 @@ void multiple_cell_document::parse_v0(xml_lmi::dom_parser const& parser)
             << LMI_FLUSH
             ;
         }
-
-    assert_vector_sizes_are_sane();
 }
 
 /// Ascertain whether input file comes from a system other than lmi.
@@ -463,6 +565,85 @@ void multiple_cell_document::write(std::ostream& os) const
 {
     assert_vector_sizes_are_sane();
 
+    write_document
+        (os
+        ,[this] (xml::element& cells)
+            {
+            for(auto const& i : cell_parms_)
+                {
+                i.write(cells);
+                }
+            }
+        );
+}
+
+/// Read a census from a file, encoding each cell as it is read.
+///
+/// Unlike the constructor, this never holds a full Input for every
+/// cell in memory.
+
+delta_census multiple_cell_document::read_delta_census
+    (std::string const& filename
+    )
+{
+    multiple_cell_document document;
+    std::unique_ptr<delta_census> census;
+    auto sink = [&] (Input const& cell)
+        {
+        if(!census)
+            {
+            census.reset
+                (new delta_census(document.case_parms_[0], document.class_parms_)
+                );
+            }
+        census->push_back(cell);
+        };
+    if(!document.stream(filename, sink))
+        {
+        xml_lmi::dom_parser parser(filename);
+        document.parse(parser, sink);
+        }
+    if(!census)
+        {
+        alarum() << "Census '" << filename << "' has no cells." << LMI_FLUSH;
+        }
+    LMI_ASSERT(1 == document.case_parms_.size());
+    LMI_ASSERT(!census->class_defaults().empty());
+    return std::move(*census);
+}
+
+/// Write a delta_census in the same format as a document, writing
+/// each cell as soon as it is materialized.
+
+void multiple_cell_document::write(std::ostream& os, delta_census const& census)
+{
+    LMI_ASSERT(!census.class_defaults().empty());
+    LMI_ASSERT(!census.empty());
+
+    multiple_cell_document document;
+    document.case_parms_ .assign(1, census.case_default());
+    document.class_parms_ = census.class_defaults();
+    document.cell_parms_ .clear();
+    document.write_document
+        (os
+        ,[&census] (xml::element& cells)
+            {
+            for(int j = 0; j < census.size(); ++j)
+                {
+                census[j].materialize().write(cells);
+                }
+            }
+        );
+}
+
+/// Write case and class defaults; 'write_cells' writes particular
+/// cells into the element passed to it.
+
+void multiple_cell_document::write_document
+    (std::ostream&                             os
+    ,std::function<void(xml::element&)> const& write_cells
+    ) const
+{
     xml_lmi::xml_document document(xml_root_name());
     xml::element& root = document.root_node();
     xml_lmi::set_attr(root, "version", class_version());
@@ -481,10 +662,7 @@ void multiple_cell_document::write(std::ostream& os) const
 
     xml::element particular_cells("particular_cells");
     xml::node::iterator cells_i = root.insert(particular_cells);
-    for(auto const& i : cell_parms_)
-        {
-        i.write(*cells_i);
-        }
+    write_cells(*cells_i);
 
     os << document;
 }
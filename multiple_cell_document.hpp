@@ -28,10 +28,13 @@
 #include "so_attributes.hpp"
 #include "xml_lmi_fwd.hpp"
 
+#include <functional>
 #include <iosfwd>
 #include <string>
 #include <vector>
 
+class delta_census;
+
 /// A census represented as an xml document.
 ///
 /// The document is composed of three vectors of class Input.
@@ -74,6 +77,11 @@
 /// case-default employee class; users have not asked for a command to
 /// add a new cell copied from a selection of class defaults, although
 /// that could of course be implemented.
+///
+/// read_delta_census() reads a census into a delta_census instead,
+/// encoding each cell as it is read, and write() can write one in
+/// the same format; thus a large census can be read and written
+/// without holding a full Input for each cell in memory.
 
 class LMI_SO multiple_cell_document final
 {
@@ -94,12 +102,24 @@ class LMI_SO multiple_cell_document final
     void read(std::istream const&);
     void write(std::ostream&) const;
 
+    static delta_census read_delta_census(std::string const& filename);
+    static void write(std::ostream&, delta_census const&);
+
   private:
     multiple_cell_document(multiple_cell_document const&) = delete;
     multiple_cell_document& operator=(multiple_cell_document const&) = delete;
 
+    typedef std::function<void(Input const&)> cell_sink;
+
+    bool stream  (std::string const& filename, cell_sink const&);
     void parse   (xml_lmi::dom_parser const&);
-    void parse_v0(xml_lmi::dom_parser const&);
+    void parse   (xml_lmi::dom_parser const&, cell_sink const&);
+    void parse_v0(xml_lmi::dom_parser const&, cell_sink const&);
+
+    void write_document
+        (std::ostream&                             os
+        ,std::function<void(xml::element&)> const& write_cells
+        ) const;
 
     void assert_vector_sizes_are_sane() const;
 
@@ -106,6 +106,16 @@ To numeric_io_cast(From from, To = To())
     return converter.operator()(from);
 }
 
+/// Overload for std::string, which is passed by reference so that it
+/// needn't be copied merely in order to be converted.
+
+template<typename To>
+To numeric_io_cast(std::string const& from, To = To())
+{
+    numeric_converter<To,std::string> converter;
+    return converter.operator()(from);
+}
+
 /// A compile-time failure iff this template is ever instantiated is
 /// desired, but the straightforward
 ///   static_assert(0, "");
@@ -137,7 +147,14 @@ struct numeric_converter<To, std::string>
     typedef std::string From;
     To operator()(From const& from) const
         {
-        char const* nptr = from.c_str();
+        return convert(from.c_str());
+        }
+
+    /// Convert a null-terminated string, for which no std::string
+    /// need be constructed except to report an error.
+
+    static To convert(char const* nptr)
+        {
         // Pointer to which strtoT()'s 'endptr' argument refers.
         char* rendptr;
         To value = numeric_conversion_traits<To>::strtoT(nptr, &rendptr);
@@ -146,7 +163,7 @@ struct numeric_converter<To, std::string>
             std::ostringstream err;
             err
                 << "Attempt to convert string '"
-                << from
+                << nptr
                 << "' from type "
                 << lmi::TypeInfo(typeid(From))
                 << " to type "
@@ -160,7 +177,7 @@ struct numeric_converter<To, std::string>
             std::ostringstream err;
             err
                 << "Attempt to convert string '"
-                << from
+                << nptr
                 << "' from type "
                 << lmi::TypeInfo(typeid(From))
                 << " to type "
@@ -190,8 +207,7 @@ struct numeric_converter<To, char const*>
                 ("Cannot convert (char const*)(0) to number."
                 );
             }
-        numeric_converter<To,std::string> z;
-        return z(from);
+        return numeric_converter<To,std::string>::convert(from);
         }
 };
 
@@ -259,7 +275,16 @@ struct numeric_converter<std::string, From>
                 return "inf";
                 }
 #endif // defined LMI_MSVCRT
-            return numeric_conversion_traits<From>::simplify(To(buffer));
+            // Construct the result directly from the buffer: the
+            // simplified number is a prefix of what was formatted.
+            char const* const begin = buffer;
+            return To
+                (begin
+                ,numeric_conversion_traits<From>::simplify
+                    (begin
+                    ,begin + actual_length
+                    )
+                );
             }
         }
 };
@@ -23,6 +23,7 @@
 
 #include "numeric_io_cast.hpp"
 
+#include "comma_punct.hpp"              // format_with_commas()
 #include "handle_exceptions.hpp"
 #include "ieee754.hpp"                  // infinity<>()
 #include "miscellany.hpp"
@@ -80,6 +81,16 @@ void mete_two_thirds()
     stifle_warning_for_unused_value(d);
 }
 
+/// Parsing alone, from a std::string too long for any small-string
+/// optimization, which mustn't be copied.
+
+void mete_two_thirds_parse()
+{
+    static std::string const s("0.66666666666666662966");
+    double d = numeric_io_cast<double>(s);
+    stifle_warning_for_unused_value(d);
+}
+
 void mete_two_thirds_boost()
 {
     std::string s = boost::lexical_cast<std::string>(2.0 / 3.0);
@@ -87,6 +98,15 @@ void mete_two_thirds_boost()
     stifle_warning_for_unused_value(d);
 }
 
+/// Fixed-decimal output with thousands separators, for comparison.
+
+void mete_two_thirds_commas()
+{
+    char buffer[comma_format_buffer_size];
+    std::size_t n = format_with_commas(buffer, sizeof buffer, 2.0e6 / 3.0, 2);
+    stifle_warning_for_unused_value(n);
+}
+
 void mete_infinity()
 {
     std::string s = numeric_io_cast<std::string>(infinity<double>());
@@ -162,7 +182,9 @@ int test_main(int, char*[])
     std::cout
         << "Conversions:"
         << "\n  2/3, lmi  : " << TimeAnAliquot(mete_two_thirds      )
+        << "\n  2/3, parse: " << TimeAnAliquot(mete_two_thirds_parse )
         << "\n  2/3, boost: " << TimeAnAliquot(mete_two_thirds_boost)
+        << "\n  2/3, comma: " << TimeAnAliquot(mete_two_thirds_commas)
         << "\n  inf, lmi  : " << TimeAnAliquot(mete_infinity        )
         << std::endl
         ;
@@ -79,27 +79,37 @@ inline int floating_point_decimals(T t)
 
 /// Simplify a formatted floating-point number.
 ///
-/// Precondition: 's' is a floating-point number formatted as if by
-/// std::snprintf() with format "%#.*f" or "%#.*Lf".
+/// Precondition: [begin, end) is a floating-point number formatted
+/// as if by std::snprintf() with format "%#.*f" or "%#.*Lf".
 ///
-/// Returns: 's' without any insignificant characters (trailing zeros
-/// after the decimal point, and the decimal point itself if followed
-/// by no nonzero digits).
+/// Returns: the end of the range without any insignificant characters
+/// (trailing zeros after the decimal point, and the decimal point
+/// itself if followed by no nonzero digits). Nothing is copied, so a
+/// number formatted in a buffer can be simplified without allocating
+/// any memory.
 ///
 /// Note: The '#' flag ensures the presence of a decimal point in the
 /// argument, which this algorithm uses as a sentinel.
 
-inline std::string simplify_floating_point(std::string const& s)
+inline char const* simplify_floating_point(char const* begin, char const* end)
 {
-    std::string::const_reverse_iterator ri = s.rbegin();
-  loop:
-    switch(*ri)
+    while(begin != end && '0' == end[-1])
+        {
+        --end;
+        }
+    if(begin != end && '.' == end[-1])
         {
-        case '0': if(++ri != s.rend()) goto loop;
-        case '.': ++ri;
-        default : ;
+        --end;
         }
-    return std::string(s.begin(), ri.base());
+    return end;
+}
+
+/// Simplify a formatted floating-point number held in a std::string.
+
+inline std::string simplify_floating_point(std::string const& s)
+{
+    char const* const begin = s.data();
+    return std::string(begin, simplify_floating_point(begin, begin + s.size()));
 }
 
 /// Traits for conversion between arithmetic types and strings.
@@ -129,7 +139,7 @@ struct numeric_conversion_traits
 {
     static int digits(T);
     static char const* fmt();
-    static std::string simplify(std::string const&);
+    static char const* simplify(char const* begin, char const* end);
     static T strtoT(char const*, char**);
 };
 
@@ -141,7 +151,7 @@ struct Integral{};
 template<> struct numeric_conversion_traits<Integral>
 {
     static int digits(long int) {return 1;}
-    static std::string simplify(std::string const& s) {return s;}
+    static char const* simplify(char const*, char const* end) {return end;}
 };
 
 template<> struct numeric_conversion_traits<char>
@@ -289,8 +299,8 @@ template<> struct numeric_conversion_traits<unsigned long long int>
 struct Floating{};
 template<> struct numeric_conversion_traits<Floating>
 {
-    static std::string simplify(std::string const& s)
-        {return simplify_floating_point(s);}
+    static char const* simplify(char const* begin, char const* end)
+        {return simplify_floating_point(begin, end);}
 };
 
 #if defined LMI_MSVCRT
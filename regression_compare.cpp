@@ -0,0 +1,64 @@
+// Compare all system-test results with touchstones in one process.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "main_common.hpp"
+#include "regression_comparison.hpp"
+#include "value_cast.hpp"
+
+#include <algorithm>                    // std::max()
+#include <cstdlib>                      // EXIT_FAILURE
+#include <iostream>
+#include <thread>
+
+/// Compare every '.test' file in a results directory with its
+/// touchstone, and write a single report to standard output.
+///
+/// Usage: regression_compare results_dir touchstone_dir [tolerance]
+///
+/// This replaces running 'ihs_crc_comp' once per file: reading and
+/// comparing files on all available cores takes far less time than
+/// spawning a process for each one.
+
+int try_main(int argc, char* argv[])
+{
+    if(argc < 3 || 4 < argc)
+        {
+        std::cerr
+            << "Usage: regression_compare"
+            << " results_dir touchstone_dir [tolerance]\n"
+            ;
+        return EXIT_FAILURE;
+        }
+
+    double const tolerance =
+          (4 == argc)
+        ? value_cast<double>(std::string(argv[3]))
+        : default_regression_tolerance
+        ;
+    int const number_of_threads =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+    write_regression_report
+        (std::cout
+        ,compare_test_directories(argv[1], argv[2], tolerance, number_of_threads)
+        );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,504 @@
+// Compare system-test results with touchstones.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "regression_comparison.hpp"
+
+#include "contains.hpp"
+#include "materially_equal.hpp"
+#include "miscellany.hpp"               // is_ok_for_cctype()
+
+#include <boost/filesystem/convenience.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>                    // std::max(), std::sort()
+#include <atomic>
+#include <cctype>                       // std::isalnum(), std::isalpha()
+#include <cmath>                        // std::fabs()
+#include <cstdlib>                      // std::strtod()
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <thread>
+
+namespace
+{
+/// A '.test' file written by Ledger::Spew(), as a sequence of named
+/// columns.
+///
+/// Each vector is written as its name on a line of its own, followed
+/// by one line per element. Scalars and strings are written as
+/// "name==value". Each variant ledger begins with "Basis==<basis>",
+/// which qualifies the names of the columns that follow it.
+///
+/// A name is recognized as a line that looks like an identifier--
+/// except for a few enumerative values that are vector elements.
+/// Some fund names look like identifiers, too, but they appear in
+/// the same places in both files being compared, so they do no harm.
+
+class spewed_ledger
+{
+  public:
+    explicit spewed_ledger(std::istream&);
+
+    struct column
+    {
+        std::string              name;
+        std::vector<std::string> values;
+    };
+
+    std::vector<column> const& columns() const {return columns_;}
+    column const* find(std::string const& name) const;
+
+  private:
+    void add_column(std::string const& name);
+
+    std::vector<column>           columns_;
+    std::map<std::string,int>     index_;
+    std::map<std::string,int>     occurrences_;
+    std::string                   basis_;
+};
+
+bool is_element_not_name(std::string const& line)
+{
+    static std::vector<std::string> const enumerative_values
+        {"A"
+        ,"B"
+        ,"ROP"
+        ,"MDB"
+        ,"Annual"
+        ,"Semiannual"
+        ,"Quarterly"
+        ,"Monthly"
+        };
+    return contains(enumerative_values, line);
+}
+
+bool looks_like_name(std::string const& line)
+{
+    if(line.empty() || !is_ok_for_cctype(line[0]) || !std::isalpha(line[0]))
+        {
+        return false;
+        }
+    for(auto const c : line)
+        {
+        if(!is_ok_for_cctype(c) || !(std::isalnum(c) || '_' == c))
+            {
+            return false;
+            }
+        }
+    return !is_element_not_name(line);
+}
+
+spewed_ledger::spewed_ledger(std::istream& is)
+{
+    std::string line;
+    while(std::getline(is, line))
+        {
+        std::string::size_type const separator = line.find("==");
+        if(std::string::npos != separator)
+            {
+            std::string const name  = line.substr(0, separator);
+            std::string const value = line.substr(2 + separator);
+            if("Basis" == name)
+                {
+                basis_ = value;
+                }
+            add_column(name);
+            columns_.back().values.push_back(value);
+            }
+        else if(looks_like_name(line))
+            {
+            add_column(line);
+            }
+        else
+            {
+            // An element that precedes any name (which Spew() never
+            // writes) is kept in a column of its own.
+            if(columns_.empty())
+                {
+                add_column("");
+                }
+            // A multiline string's continuation lines are treated
+            // as further elements of the string.
+            columns_.back().values.push_back(line);
+            }
+        }
+}
+
+spewed_ledger::column const* spewed_ledger::find(std::string const& name) const
+{
+    auto const i = index_.find(name);
+    return (index_.end() == i) ? nullptr : &columns_[i->second];
+}
+
+/// Qualify each name by its basis, and number any duplicates so that
+/// they can be matched with their counterparts.
+
+void spewed_ledger::add_column(std::string const& name)
+{
+    std::string qualified = name;
+    if(!basis_.empty())
+        {
+        qualified += " [" + basis_ + "]";
+        }
+    int const n = ++occurrences_[qualified];
+    if(1 < n)
+        {
+        qualified += " #" + std::to_string(n);
+        }
+    index_[qualified] = static_cast<int>(columns_.size());
+    columns_.push_back({qualified, {}});
+}
+
+bool is_number(std::string const& s, double& d)
+{
+    if(s.empty())
+        {
+        return false;
+        }
+    char* end = nullptr;
+    d = std::strtod(s.c_str(), &end);
+    return '\0' == *end;
+}
+
+/// Relative error, calculated as 'ihs_crc_comp' has always done.
+
+double relative_error(double observed, double expected)
+{
+    double const denominator = (0.0 == observed) ? expected : observed;
+    return std::fabs((observed - expected) / denominator);
+}
+
+void compare_columns
+    (spewed_ledger::column const& observed
+    ,spewed_ledger::column const& expected
+    ,double                       tolerance
+    ,test_file_comparison&        z
+    )
+{
+    ++z.columns_compared;
+    column_discrepancy d {observed.name, 0, -1, "", "", 0.0};
+    if(observed.values.size() != expected.values.size())
+        {
+        d.number_of_differences = 1;
+        d.observed = "length " + std::to_string(observed.values.size());
+        d.expected = "length " + std::to_string(expected.values.size());
+        z.discrepancies.push_back(d);
+        return;
+        }
+
+    for(std::size_t j = 0; j < observed.values.size(); ++j)
+        {
+        std::string const& o = observed.values[j];
+        std::string const& e = expected.values[j];
+        if(o == e)
+            {
+            continue;
+            }
+
+        double x;
+        double y;
+        bool material = true;
+        if(is_number(o, x) && is_number(e, y))
+            {
+            if(x == y)
+                {
+                continue;
+                }
+            double const rel_err = relative_error(x, y);
+            z.max_abs_diff = std::max(z.max_abs_diff, std::fabs(x - y));
+            z.max_rel_err  = std::max(z.max_rel_err , rel_err);
+            material = !materially_equal(x, y, tolerance);
+            if(material)
+                {
+                d.max_rel_err = std::max(d.max_rel_err, rel_err);
+                }
+            }
+
+        if(material)
+            {
+            if(0 == d.number_of_differences++)
+                {
+                d.index    = static_cast<int>(j);
+                d.observed = o;
+                d.expected = e;
+                }
+            }
+        }
+
+    if(0 != d.number_of_differences)
+        {
+        z.discrepancies.push_back(d);
+        }
+}
+
+test_file_comparison compare_test_files
+    (fs::path const& results_file
+    ,fs::path const& touchstone_file
+    ,double          tolerance
+    )
+{
+    test_file_comparison z;
+    z.filename = fs::basename(results_file) + fs::extension(results_file);
+    if(!fs::exists(touchstone_file))
+        {
+        z.touchstone_found = false;
+        return z;
+        }
+
+    fs::ifstream observed(results_file);
+    fs::ifstream expected(touchstone_file);
+    if(!observed || !expected)
+        {
+        z.error = "unable to read file";
+        return z;
+        }
+
+    test_file_comparison t = compare_test_data(observed, expected, tolerance);
+    t.filename = z.filename;
+    return t;
+}
+} // Unnamed namespace.
+
+test_file_comparison::test_file_comparison()
+    :touchstone_found (true)
+    ,columns_compared (0)
+    ,max_abs_diff     (0.0)
+    ,max_rel_err      (0.0)
+{
+}
+
+/// True iff no value differs at all.
+
+bool test_file_comparison::is_identical() const
+{
+    return
+           touchstone_found
+        && error.empty()
+        && discrepancies.empty()
+        && 0.0 == max_abs_diff
+        ;
+}
+
+/// True iff no value differs materially.
+
+bool test_file_comparison::is_within_tolerance() const
+{
+    return touchstone_found && error.empty() && discrepancies.empty();
+}
+
+/// Compare one '.test' file with its touchstone, column by column.
+///
+/// Values that are equal as strings are equal. Otherwise, numeric
+/// values are compared with materially_equal(), and any others are
+/// unequal. The maximum absolute difference and relative error are
+/// accumulated over all differing numeric values, even those that
+/// are within tolerance, as 'ihs_crc_comp' has always reported them.
+
+test_file_comparison compare_test_data
+    (std::istream& observed
+    ,std::istream& expected
+    ,double        tolerance
+    )
+{
+    spewed_ledger const o(observed);
+    spewed_ledger const e(expected);
+
+    test_file_comparison z;
+    for(auto const& i : o.columns())
+        {
+        spewed_ledger::column const* j = e.find(i.name);
+        if(j)
+            {
+            compare_columns(i, *j, tolerance, z);
+            }
+        else
+            {
+            z.discrepancies.push_back({i.name, 1, -1, "present", "absent", 0.0});
+            }
+        }
+    for(auto const& j : e.columns())
+        {
+        if(!o.find(j.name))
+            {
+            z.discrepancies.push_back({j.name, 1, -1, "absent", "present", 0.0});
+            }
+        }
+    return z;
+}
+
+/// Compare every '.test' file in 'results_dir' with its namesake in
+/// 'touchstone_dir'.
+///
+/// Files are compared on the given number of threads. The results
+/// are sorted by filename, regardless of the number of threads.
+
+std::vector<test_file_comparison> compare_test_directories
+    (fs::path const& results_dir
+    ,fs::path const& touchstone_dir
+    ,double          tolerance
+    ,int             number_of_threads
+    )
+{
+    std::vector<fs::path> files;
+    fs::directory_iterator end_i;
+    for(fs::directory_iterator i(results_dir); i != end_i; ++i)
+        {
+        if(!fs::is_directory(*i) && ".test" == fs::extension(*i))
+            {
+            files.push_back(*i);
+            }
+        }
+    std::sort(files.begin(), files.end());
+
+    std::vector<test_file_comparison> z(files.size());
+    std::atomic<std::size_t> next_file(0);
+    auto work = [&] ()
+        {
+        for(std::size_t j = next_file++; j < files.size(); j = next_file++)
+            {
+            try
+                {
+                z[j] = compare_test_files
+                    (files[j]
+                    ,touchstone_dir / (fs::basename(files[j]) + ".test")
+                    ,tolerance
+                    );
+                }
+            catch(std::exception const& e)
+                {
+                z[j].filename = fs::basename(files[j]) + ".test";
+                z[j].error = e.what();
+                }
+            }
+        };
+
+    std::vector<std::thread> threads;
+    for(int j = 1; j < number_of_threads; ++j)
+        {
+        threads.emplace_back(work);
+        }
+    work();
+    for(auto& t : threads)
+        {
+        t.join();
+        }
+    return z;
+}
+
+/// Write one report for all comparisons.
+///
+/// Each file's summary is formatted as 'ihs_crc_comp' formatted it,
+/// prefixed by the filename, so that existing filters still apply.
+/// Each material discrepancy is described on an indented line of
+/// its own, and totals follow all files.
+
+void write_regression_report
+    (std::ostream&                            os
+    ,std::vector<test_file_comparison> const& comparisons
+    )
+{
+    int identical        = 0;
+    int within_tolerance = 0;
+    int differing        = 0;
+    int unmatched        = 0;
+
+    std::streamsize const original_precision = os.precision();
+    for(auto const& i : comparisons)
+        {
+        if(!i.touchstone_found)
+            {
+            ++unmatched;
+            os << i.filename << "   No touchstone.\n";
+            continue;
+            }
+        if(!i.error.empty())
+            {
+            ++differing;
+            os << i.filename << "   Error: " << i.error << '\n';
+            continue;
+            }
+
+        os
+            << std::setprecision(6)
+            << i.filename
+            << "   Summary:"
+            << " max abs diff: " << i.max_abs_diff
+            << " max rel err:  " << i.max_rel_err
+            << '\n'
+            ;
+        os << std::setprecision(20);
+        for(auto const& d : i.discrepancies)
+            {
+            os << "    " << d.name << ": ";
+            if(-1 == d.index)
+                {
+                os << d.observed << " vs. " << d.expected << '\n';
+                continue;
+                }
+            os
+                << d.number_of_differences
+                << " values differ; first at ["
+                << d.index
+                << "]: "
+                << d.observed
+                << " vs. "
+                << d.expected
+                ;
+            if(0.0 != d.max_rel_err)
+                {
+                os << "; max rel err " << d.max_rel_err;
+                }
+            os << '\n';
+            }
+
+        if(i.is_identical())
+            {
+            ++identical;
+            }
+        else if(i.is_within_tolerance())
+            {
+            ++within_tolerance;
+            }
+        else
+            {
+            ++differing;
+            }
+        }
+    os.precision(original_precision);
+
+    os
+        << "Compared "
+        << comparisons.size() - unmatched
+        << " files: "
+        << identical
+        << " identical, "
+        << within_tolerance
+        << " within tolerance, "
+        << differing
+        << " materially different; "
+        << unmatched
+        << " without touchstone.\n"
+        ;
+}
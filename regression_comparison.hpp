@@ -0,0 +1,92 @@
+// Compare system-test results with touchstones.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef regression_comparison_hpp
+#define regression_comparison_hpp
+
+#include "config.hpp"
+
+#include <boost/filesystem/path.hpp>
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// Relative errors smaller than this are ignored by default. See the
+/// discussion of the 'system_test' target in 'workhorse.make'.
+
+double const default_regression_tolerance = 1.0E-14;
+
+/// The way one column of a '.test' file differs from its touchstone.
+///
+/// A column is a ledger vector, or a scalar or string treated as a
+/// vector of length one. Its name is qualified by the run basis of
+/// the variant ledger that contains it, if any. If the column is
+/// present in only one file, or its lengths differ, then 'index' is
+/// -1 and 'observed' and 'expected' describe the structural problem.
+
+struct column_discrepancy
+{
+    std::string name;
+    int         number_of_differences;
+    int         index;
+    std::string observed;
+    std::string expected;
+    double      max_rel_err;
+};
+
+/// The result of comparing one '.test' file with its touchstone.
+
+struct test_file_comparison
+{
+    test_file_comparison();
+
+    bool is_identical() const;
+    bool is_within_tolerance() const;
+
+    std::string                     filename;
+    bool                            touchstone_found;
+    std::string                     error;
+    int                             columns_compared;
+    double                          max_abs_diff;
+    double                          max_rel_err;
+    std::vector<column_discrepancy> discrepancies;
+};
+
+test_file_comparison compare_test_data
+    (std::istream& observed
+    ,std::istream& expected
+    ,double        tolerance = default_regression_tolerance
+    );
+
+std::vector<test_file_comparison> compare_test_directories
+    (fs::path const& results_dir
+    ,fs::path const& touchstone_dir
+    ,double          tolerance
+    ,int             number_of_threads
+    );
+
+void write_regression_report
+    (std::ostream&                            os
+    ,std::vector<test_file_comparison> const& comparisons
+    );
+
+#endif // regression_comparison_hpp
@@ -0,0 +1,206 @@
+// Compare system-test results with touchstones: unit test.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "regression_comparison.hpp"
+
+#include "assert_lmi.hpp"
+#include "test_tools.hpp"
+
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <sstream>
+
+namespace
+{
+/// Abridged output of Ledger::Spew(), with a fund name that looks
+/// like a vector's name.
+
+std::string const touchstone =
+    "AcctVal\n"
+    "1000\n"
+    "2000.5\n"
+    "3001.25\n"
+    "FundNames\n"
+    "Equity\n"
+    "Money Market\n"
+    "DBOpt\n"
+    "A\n"
+    "ROP\n"
+    "Age==45\n"
+    "ProductName==sample\n"
+    "Basis==mce_run_gen_curr_sep_full\n"
+    "CSVNet\n"
+    "900\n"
+    "1800\n"
+    "Basis==mce_run_gen_guar_sep_full\n"
+    "CSVNet\n"
+    "800\n"
+    "1600\n"
+    ;
+
+test_file_comparison compare(std::string const& observed)
+{
+    std::istringstream o(observed);
+    std::istringstream e(touchstone);
+    return compare_test_data(o, e);
+}
+
+std::string replace
+    (std::string        s
+    ,std::string const& from
+    ,std::string const& to
+    )
+{
+    std::string::size_type const k = s.find(from);
+    LMI_ASSERT(std::string::npos != k);
+    return s.replace(k, from.size(), to);
+}
+
+void write_file(fs::path const& p, std::string const& contents)
+{
+    fs::ofstream os(p);
+    os << contents;
+}
+} // Unnamed namespace.
+
+void test_identical()
+{
+    test_file_comparison const z = compare(touchstone);
+    BOOST_TEST(z.is_identical());
+    BOOST_TEST(z.is_within_tolerance());
+    BOOST_TEST_EQUAL(0.0, z.max_abs_diff);
+    BOOST_TEST_EQUAL(0.0, z.max_rel_err);
+    // Six columns, two more for each basis, and spurious "Equity".
+    BOOST_TEST_EQUAL(10, z.columns_compared);
+}
+
+void test_numeric_differences()
+{
+    // Different formatting of the same value is no difference.
+    test_file_comparison z = compare(replace(touchstone, "2000.5", "2.0005e3"));
+    BOOST_TEST(z.is_identical());
+
+    // A difference within tolerance is reported, but not as material.
+    z = compare(replace(touchstone, "3001.25", "3001.2500000000005"));
+    BOOST_TEST(!z.is_identical());
+    BOOST_TEST(z.is_within_tolerance());
+    BOOST_TEST(0.0 < z.max_rel_err && z.max_rel_err < 1.0E-14);
+
+    // A material difference is identified by column, basis, and index.
+    z = compare(replace(touchstone, "1600", "1601"));
+    BOOST_TEST(!z.is_within_tolerance());
+    BOOST_TEST_EQUAL(1.0, z.max_abs_diff);
+    BOOST_TEST_EQUAL(1, z.discrepancies.size());
+    column_discrepancy const& d = z.discrepancies.front();
+    BOOST_TEST_EQUAL("CSVNet [mce_run_gen_guar_sep_full]", d.name);
+    BOOST_TEST_EQUAL(1, d.number_of_differences);
+    BOOST_TEST_EQUAL(1, d.index);
+    BOOST_TEST_EQUAL("1601", d.observed);
+    BOOST_TEST_EQUAL("1600", d.expected);
+    BOOST_TEST_EQUAL(1.0 / 1601.0, d.max_rel_err);
+
+    // A looser tolerance ignores it.
+    std::istringstream o(replace(touchstone, "1600", "1601"));
+    std::istringstream e(touchstone);
+    BOOST_TEST(compare_test_data(o, e, 0.001).is_within_tolerance());
+}
+
+void test_other_differences()
+{
+    test_file_comparison z = compare(replace(touchstone, "=sample", "=other"));
+    BOOST_TEST_EQUAL(1, z.discrepancies.size());
+    BOOST_TEST_EQUAL("ProductName", z.discrepancies.front().name);
+    BOOST_TEST_EQUAL(0.0, z.max_rel_err);
+
+    z = compare(replace(touchstone, "\nROP\n", "\nROP\nA\n"));
+    BOOST_TEST_EQUAL(1, z.discrepancies.size());
+    BOOST_TEST_EQUAL(-1, z.discrepancies.front().index);
+    BOOST_TEST_EQUAL("length 3", z.discrepancies.front().observed);
+
+    z = compare(replace(touchstone, "Age==45\n", ""));
+    BOOST_TEST_EQUAL(1, z.discrepancies.size());
+    BOOST_TEST_EQUAL("Age", z.discrepancies.front().name);
+    BOOST_TEST_EQUAL("absent", z.discrepancies.front().observed);
+}
+
+void test_directories()
+{
+    fs::path const results("regression_comparison_test_results");
+    fs::path const touchstones("regression_comparison_test_touchstones");
+    fs::create_directory(results);
+    fs::create_directory(touchstones);
+
+    write_file(results     / "a.test"     , touchstone);
+    write_file(touchstones / "a.test"     , touchstone);
+    write_file(results     / "b.test"     , replace(touchstone, "900", "901"));
+    write_file(touchstones / "b.test"     , touchstone);
+    write_file(results     / "c.test"     , touchstone);
+    write_file(results     / "d.monthly_trace.tsv", "");
+
+    for(int threads = 1; threads <= 4; ++threads)
+        {
+        std::vector<test_file_comparison> const z = compare_test_directories
+            (results
+            ,touchstones
+            ,default_regression_tolerance
+            ,threads
+            );
+        BOOST_TEST_EQUAL(3, z.size());
+        BOOST_TEST_EQUAL("a.test", z[0].filename);
+        BOOST_TEST(z[0].is_identical());
+        BOOST_TEST_EQUAL("b.test", z[1].filename);
+        BOOST_TEST(!z[1].is_within_tolerance());
+        BOOST_TEST_EQUAL("c.test", z[2].filename);
+        BOOST_TEST(!z[2].touchstone_found);
+
+        std::ostringstream os;
+        write_regression_report(os, z);
+        std::string const report = os.str();
+        BOOST_TEST(std::string::npos != report.find
+            ("a.test   Summary: max abs diff: 0 max rel err:  0\n")
+            );
+        BOOST_TEST(std::string::npos != report.find
+            ("    CSVNet [mce_run_gen_curr_sep_full]: 1 values differ;")
+            );
+        BOOST_TEST(std::string::npos != report.find("c.test   No touchstone.\n"));
+        BOOST_TEST(std::string::npos != report.find
+            ("Compared 2 files: 1 identical, 0 within tolerance,"
+             " 1 materially different; 1 without touchstone.\n"
+            )
+            );
+        }
+
+    fs::remove_all(results);
+    fs::remove_all(touchstones);
+}
+
+int test_main(int, char*[])
+{
+    test_identical();
+    test_numeric_differences();
+    test_other_differences();
+    test_directories();
+
+    return EXIT_SUCCESS;
+}
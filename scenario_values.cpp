@@ -0,0 +1,252 @@
+// Values for one cell under alternative scenarios.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "scenario_values.hpp"
+
+#include "account_value.hpp"
+#include "alert.hpp"
+#include "assert_lmi.hpp"
+#include "basic_values.hpp"             // BasicValues::IsRevisable()
+#include "fenv_guard.hpp"
+#include "input.hpp"
+#include "ledger.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "miscellany.hpp"               // ltrim(), rtrim()
+#include "timer.hpp"
+#include "value_cast.hpp"
+
+#include <algorithm>                    // std::max()
+#include <exception>
+#include <istream>
+#include <memory>                       // std::unique_ptr
+#include <ostream>
+#include <sstream>
+
+namespace
+{
+/// Read the next nonblank line, trimmed; return false at end of file.
+
+bool next_nonblank_line(std::istream& is, std::string& line)
+{
+    while(std::getline(is, line))
+        {
+        rtrim(line, " \t\r");
+        ltrim(line, " \t");
+        if(!line.empty())
+            {
+            return true;
+            }
+        }
+    return false;
+}
+
+/// Find a named ledger column: current basis first, then invariant.
+
+std::vector<double> const& find_column
+    (Ledger      const& ledger
+    ,std::string const& name
+    )
+{
+    double_vector_map const& v = ledger.GetCurrFull().all_vectors();
+    double_vector_map::const_iterator i = v.find(name);
+    if(v.end() != i)
+        {
+        return *i->second;
+        }
+
+    double_vector_map const& w = ledger.GetLedgerInvariant().all_vectors();
+    double_vector_map::const_iterator j = w.find(name);
+    if(w.end() != j)
+        {
+        return *j->second;
+        }
+
+    alarum() << "Ledger column '" << name << "' not found." << LMI_FLUSH;
+    throw "Unreachable--silences a compiler diagnostic.";
+}
+} // Unnamed namespace.
+
+scenario_specification read_scenario_specification(std::istream& is)
+{
+    scenario_specification z;
+
+    if(!next_nonblank_line(is, z.field_))
+        {
+        alarum() << "Scenario specification is empty." << LMI_FLUSH;
+        }
+
+    std::string columns;
+    if(!next_nonblank_line(is, columns))
+        {
+        alarum() << "Scenario specification names no columns." << LMI_FLUSH;
+        }
+    std::istringstream iss(columns);
+    std::string column;
+    while(std::getline(iss, column, ','))
+        {
+        rtrim(column, " \t");
+        ltrim(column, " \t");
+        if(!column.empty())
+            {
+            z.columns_.push_back(column);
+            }
+        }
+
+    std::string value;
+    while(next_nonblank_line(is, value))
+        {
+        z.values_.push_back(value);
+        }
+    if(z.values_.empty())
+        {
+        alarum() << "Scenario specification has no scenarios." << LMI_FLUSH;
+        }
+
+    return z;
+}
+
+/// Run every scenario.
+///
+/// Scenarios are run in the order specified; an error in any one of
+/// them is reported with the offending value, and no further
+/// scenarios are run.
+///
+/// If the field that varies is one that BasicValues::IsRevisable()
+/// accepts, the AccountValue object constructed for the first
+/// scenario is reused for the others, so that BasicValues is
+/// initialized only once; otherwise, a new object is constructed for
+/// each scenario.
+
+scenario_values::scenario_values
+    (std::string            const& filename
+    ,Input                  const& cell
+    ,scenario_specification const& specification
+    )
+    :specification_           (specification)
+    ,seconds_for_calculations_ (0.0)
+{
+    Timer timer;
+    bool const reusable = BasicValues::IsRevisable(specification_.field_);
+    std::unique_ptr<AccountValue> av;
+    for(auto const& value : specification_.values_)
+        {
+        Input input(cell);
+        try
+            {
+            input[specification_.field_] = value;
+            input.RealizeAllSequenceInput();
+            }
+        catch(std::exception const& e)
+            {
+            alarum()
+                << "Scenario '"
+                << value
+                << "' for input field '"
+                << specification_.field_
+                << "': "
+                << e.what()
+                << LMI_FLUSH
+                ;
+            }
+        fenv_guard fg;
+        if(reusable && av)
+            {
+            av->ReviseInput(input);
+            }
+        else
+            {
+            av.reset(new AccountValue(input));
+            }
+        av->SetDebugFilename(filename);
+        av->RunAV();
+        ledgers_.push_back(av->ledger_from_av());
+        }
+    seconds_for_calculations_ = timer.stop().elapsed_seconds();
+}
+
+std::vector<std::shared_ptr<Ledger const>> const& scenario_values::ledgers() const
+{
+    return ledgers_;
+}
+
+void scenario_values::write_matrix(std::ostream& os) const
+{
+    write_scenario_matrix(os, specification_, ledgers_);
+}
+
+double scenario_values::seconds_for_calculations() const
+{
+    return seconds_for_calculations_;
+}
+
+/// Write a duration-by-scenario matrix of the specified columns.
+///
+/// The output is tab delimited, for spreadsheets. The first row names
+/// each column and scenario; each subsequent row is one policy year.
+/// Scenarios may mature at different durations only if the field
+/// that varies affects maturity, in which case shorter columns are
+/// left blank.
+
+void write_scenario_matrix
+    (std::ostream&                                     os
+    ,scenario_specification                     const& specification
+    ,std::vector<std::shared_ptr<Ledger const>> const& ledgers
+    )
+{
+    LMI_ASSERT(ledgers.size() == specification.values_.size());
+
+    os << "PolicyYear";
+    for(auto const& value : specification.values_)
+        {
+        for(auto const& column : specification.columns_)
+            {
+            os << '\t' << column << " [" << value << "]";
+            }
+        }
+    os << '\n';
+
+    int length = 0;
+    for(auto const& ledger : ledgers)
+        {
+        length = std::max(length, ledger->GetMaxLength());
+        }
+
+    for(int j = 0; j < length; ++j)
+        {
+        os << 1 + j;
+        for(auto const& ledger : ledgers)
+            {
+            for(auto const& column : specification.columns_)
+                {
+                std::vector<double> const& v = find_column(*ledger, column);
+                os << '\t';
+                if(j < static_cast<int>(v.size()))
+                    {
+                    os << value_cast<std::string>(v[j]);
+                    }
+                }
+            }
+        os << '\n';
+        }
+}
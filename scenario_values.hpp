@@ -0,0 +1,110 @@
+// Values for one cell under alternative scenarios.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#ifndef scenario_values_hpp
+#define scenario_values_hpp
+
+#include "config.hpp"
+
+#include "so_attributes.hpp"
+
+#include <iosfwd>
+#include <memory>                       // std::shared_ptr
+#include <string>
+#include <vector>
+
+class Input;
+class Ledger;
+
+/// Specification of alternative scenarios for a single cell.
+///
+/// Each scenario assigns one value to the same input field, e.g.:
+///   field:   "GeneralAccountRate"
+///   values:  {"0.04", "0.05", "0.06; 0.04 10"}
+/// Values may be anything the field accepts, including input-sequence
+/// expressions. Columns name ledger vectors to be reported for each
+/// scenario: current-basis values (e.g., "AcctVal", "CSVNet"), or
+/// basis-invariant values (e.g., "GrossPmt").
+///
+/// Implicitly-declared special member functions do the right thing.
+
+struct scenario_specification
+{
+    std::string              field_;
+    std::vector<std::string> values_;
+    std::vector<std::string> columns_;
+};
+
+/// Read a scenario specification from a stream.
+///
+/// Format: the first nonblank line names the input field; the second
+/// lists the ledger columns, separated by commas; and each subsequent
+/// nonblank line is one scenario's value for the field.
+
+scenario_specification LMI_SO read_scenario_specification(std::istream&);
+
+/// Run one cell under alternative scenarios.
+///
+/// Sensitivity studies need many illustrations that differ only in
+/// one input field, such as 'GeneralAccountRate'. Running them here
+/// reads input only once, and writes a compact duration-by-scenario
+/// matrix of only the wanted columns, instead of writing a complete
+/// set of output for each scenario.
+///
+/// BasicValues is initialized only once if the field that varies
+/// affects it only through members that are cheap to rebuild, such
+/// as interest rates ('GeneralAccountRate') or outlay ('Payment');
+/// see BasicValues::IsRevisable(). Otherwise, each scenario is a
+/// complete, independent run, just as if it were a separate '.ill'
+/// file, because the field may affect anything that BasicValues
+/// initializes (e.g., COI multipliers). Either way, results are the
+/// same as for separate runs.
+///
+/// Implicitly-declared special member functions do the right thing.
+
+class LMI_SO scenario_values final
+{
+  public:
+    scenario_values
+        (std::string            const& filename
+        ,Input                  const& cell
+        ,scenario_specification const& specification
+        );
+
+    std::vector<std::shared_ptr<Ledger const>> const& ledgers() const;
+
+    void write_matrix(std::ostream&) const;
+
+    double seconds_for_calculations() const;
+
+  private:
+    scenario_specification specification_;
+    std::vector<std::shared_ptr<Ledger const>> ledgers_;
+    double seconds_for_calculations_;
+};
+
+void LMI_SO write_scenario_matrix
+    (std::ostream&                                     os
+    ,scenario_specification                     const& specification
+    ,std::vector<std::shared_ptr<Ledger const>> const& ledgers
+    );
+
+#endif // scenario_values_hpp
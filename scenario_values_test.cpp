@@ -0,0 +1,177 @@
+// Run one cell under alternative input values--unit test.
+//
+// Copyright (C) 2017 Gregory W. Chicares.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License version 2 as
+// published by the Free Software Foundation.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software Foundation,
+// Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+//
+// http://savannah.nongnu.org/projects/lmi
+// email: <gchicares@sbcglobal.net>
+// snail: Chicares, 186 Belle Woods Drive, Glastonbury CT 06033, USA
+
+#include "pchfile.hpp"
+
+#include "scenario_values.hpp"
+
+#include "ledger.hpp"
+#include "ledger_invariant.hpp"
+#include "ledger_variant.hpp"
+#include "test_tools.hpp"
+
+#include <memory>                       // std::shared_ptr
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+/// A ledger whose current-basis account value in year j is 'base'
+/// plus j, and whose gross premium is 100 times (1 + j). It lapses
+/// at the end of 'lapse_year' years, which determines how many years
+/// are written.
+
+std::shared_ptr<Ledger const> make_ledger
+    (int    length
+    ,int    lapse_year
+    ,double base
+    )
+{
+    std::shared_ptr<Ledger> z
+        (new Ledger(length, mce_ill_reg, false, false, false)
+        );
+
+    LedgerInvariant invariant(length);
+    for(int j = 0; j < length; ++j)
+        {
+        invariant.GrossPmt[j] = 100.0 * (1 + j);
+        }
+    z->SetLedgerInvariant(invariant);
+
+    for(auto const& basis : z->GetRunBases())
+        {
+        LedgerVariant variant(length);
+        variant.set_run_basis(basis);
+        for(int j = 0; j < length; ++j)
+            {
+            variant.AcctVal[j] = base + j;
+            }
+        variant.LapseYear = lapse_year;
+        z->SetOneLedgerVariant(basis, variant);
+        }
+    return z;
+}
+
+scenario_specification specification_from(std::string const& s)
+{
+    std::istringstream iss(s);
+    return read_scenario_specification(iss);
+}
+} // Unnamed namespace.
+
+void test_read_scenario_specification()
+{
+    // Blank lines are skipped, and whitespace (including a carriage
+    // return, as in a file written on msw) is trimmed.
+    scenario_specification const z = specification_from
+        ("\n"
+         "  GeneralAccountRate \r\n"
+         "AcctVal, GrossPmt ,,CSVNet\n"
+         "\n"
+         "0.04\n"
+         "\t0.06; 0.04 10  \n"
+        );
+    BOOST_TEST_EQUAL("GeneralAccountRate", z.field_);
+    BOOST_TEST_EQUAL(3, z.columns_.size());
+    BOOST_TEST_EQUAL("AcctVal" , z.columns_[0]);
+    BOOST_TEST_EQUAL("GrossPmt", z.columns_[1]);
+    BOOST_TEST_EQUAL("CSVNet"  , z.columns_[2]);
+    BOOST_TEST_EQUAL(2, z.values_.size());
+    BOOST_TEST_EQUAL("0.04"         , z.values_[0]);
+    BOOST_TEST_EQUAL("0.06; 0.04 10", z.values_[1]);
+
+    BOOST_TEST_THROW
+        (specification_from("\n \n")
+        ,std::runtime_error
+        ,"Scenario specification is empty."
+        );
+
+    BOOST_TEST_THROW
+        (specification_from("GeneralAccountRate\n")
+        ,std::runtime_error
+        ,"Scenario specification names no columns."
+        );
+
+    BOOST_TEST_THROW
+        (specification_from("GeneralAccountRate\nAcctVal\n\n")
+        ,std::runtime_error
+        ,"Scenario specification has no scenarios."
+        );
+}
+
+void test_write_scenario_matrix()
+{
+    scenario_specification const z = specification_from
+        ("GeneralAccountRate\n"
+         "AcctVal,GrossPmt\n"
+         "0.04\n"
+         "0.06\n"
+        );
+
+    // The second scenario matures sooner; its columns are left blank
+    // thereafter.
+    std::vector<std::shared_ptr<Ledger const>> const ledgers
+        {make_ledger(3, 3, 1000.0)
+        ,make_ledger(2, 2, 2000.5)
+        };
+
+    std::ostringstream oss;
+    write_scenario_matrix(oss, z, ledgers);
+    BOOST_TEST_EQUAL
+        (oss.str()
+        ,"PolicyYear"
+         "\tAcctVal [0.04]\tGrossPmt [0.04]"
+         "\tAcctVal [0.06]\tGrossPmt [0.06]\n"
+         "1\t1000\t100\t2000.5\t100\n"
+         "2\t1001\t200\t2001.5\t200\n"
+         "3\t1002\t300\t\t\n"
+        );
+
+    // Each scenario must have a ledger.
+    std::vector<std::shared_ptr<Ledger const>> const too_few {ledgers[0]};
+    BOOST_TEST_THROW
+        (write_scenario_matrix(oss, z, too_few)
+        ,std::runtime_error
+        ,"Assertion 'ledgers.size() == specification.values_.size()' failed."
+        );
+
+    // Columns must name ledger vectors.
+    scenario_specification const bad = specification_from
+        ("GeneralAccountRate\n"
+         "NoSuchColumn\n"
+         "0.04\n"
+         "0.06\n"
+        );
+    BOOST_TEST_THROW
+        (write_scenario_matrix(oss, bad, ledgers)
+        ,std::runtime_error
+        ,"Ledger column 'NoSuchColumn' not found."
+        );
+}
+
+int test_main(int, char*[])
+{
+    test_read_scenario_specification();
+    test_write_scenario_matrix();
+    return EXIT_SUCCESS;
+}
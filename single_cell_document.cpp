@@ -26,6 +26,7 @@
 #include "alert.hpp"
 #include "assert_lmi.hpp"
 #include "data_directory.hpp"           // AddDataDir()
+#include "input_xml_reader.hpp"
 #include "xml_lmi.hpp"
 
 #include <xmlwrapp/document.h>
@@ -37,6 +38,7 @@
 #include <istream>
 #include <ostream>
 #include <sstream>
+#include <vector>
 
 //============================================================================
 single_cell_document::single_cell_document(Input const& z)
@@ -49,8 +51,11 @@ single_cell_document::single_cell_document(Input const& z)
 single_cell_document::single_cell_document(std::string const& filename)
     :input_data_()
 {
-    xml_lmi::dom_parser parser(filename);
-    parse(parser);
+    if(!stream(filename))
+        {
+        xml_lmi::dom_parser parser(filename);
+        parse(parser);
+        }
 }
 
 /// Backward-compatibility serial number of this class's xml version.
@@ -73,6 +78,37 @@ std::string const& single_cell_document::xml_root_name() const
     return s;
 }
 
+/// Read a file written by lmi without building a DOM, if possible.
+///
+/// Returns false, having read nothing, if the file must be parsed
+/// into a DOM instead.
+
+bool single_cell_document::stream(std::string const& filename)
+{
+    int number_of_cells = 0;
+    bool const okay = read_input_cells
+        (filename
+        ,xml_root_name()
+        ,class_version()
+        ,std::vector<std::string>()
+        ,input_data_
+        ,[&number_of_cells] (std::string const&) {++number_of_cells;}
+        );
+    // An '.ill' document's root contains only one child element.
+    if(okay && 1 != number_of_cells)
+        {
+        alarum()
+            << "Input file '"
+            << filename
+            << "' has "
+            << number_of_cells
+            << " cells, but must have exactly one."
+            << LMI_FLUSH
+            ;
+        }
+    return okay;
+}
+
 //============================================================================
 void single_cell_document::parse(xml_lmi::dom_parser const& parser)
 {
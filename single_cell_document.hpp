@@ -52,6 +52,7 @@ class LMI_SO single_cell_document final
     single_cell_document(single_cell_document const&) = delete;
     single_cell_document& operator=(single_cell_document const&) = delete;
 
+    bool stream(std::string const& filename);
     void parse(xml_lmi::dom_parser const&);
 
     int                class_version() const;
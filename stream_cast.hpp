@@ -156,6 +156,21 @@ To stream_cast(From from, To = To())
     return result;
 }
 
+/// Ascertain whether stream_cast would extract a string verbatim.
+///
+/// stream_cast treats every whitespace character but blank as a
+/// delimiter. A nonempty string that contains no such delimiter is
+/// therefore extracted whole, so a type that extracts itself from a
+/// stream by extracting a string and then assigning it may instead
+/// assign that string directly, without the considerable overhead of
+/// a std::stringstream. See the value_cast() overloads for tn_range
+/// and mc_enum.
+
+inline bool stream_extracts_verbatim(std::string const& s)
+{
+    return !s.empty() && std::string::npos == s.find_first_of("\t\n\v\f\r");
+}
+
 template<>
 inline std::string stream_cast<std::string>(char* from, std::string)
 {
@@ -25,6 +25,7 @@
 #include "config.hpp"
 
 #include "datum_base.hpp"
+#include "stream_cast.hpp"
 
 #include <boost/operators.hpp>
 
@@ -290,5 +291,29 @@ class tn_range
     Number value_;
 };
 
+/// Convert a string to a tn_range without a std::stringstream.
+///
+/// The generic value_cast() would use stream_cast(), which extracts
+/// a token and assigns it. When the token would be the whole string,
+/// assigning the string directly has the same effect, and is much
+/// faster: this is the commonest conversion when xml is read. Other
+/// strings are still passed to stream_cast(), so that its diagnostics
+/// are unchanged.
+
+template<typename Number, typename Trammel>
+inline tn_range<Number,Trammel> value_cast
+    (std::string const&       from
+    ,tn_range<Number,Trammel>
+    )
+{
+    if(!stream_extracts_verbatim(from))
+        {
+        return stream_cast<tn_range<Number,Trammel>>(from);
+        }
+    tn_range<Number,Trammel> z;
+    z = from;
+    return z;
+}
+
 #endif // tn_range_hpp
 
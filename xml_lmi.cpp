@@ -24,7 +24,9 @@
 #include "xml_lmi.hpp"
 
 #include "alert.hpp"
+#include "gzip_stream.hpp"
 #include "istream_to_string.hpp"
+#include "miscellany.hpp"               // ios_in_binary()
 #include "platform_dependent.hpp"       // access()
 #include "value_cast.hpp"
 
@@ -33,6 +35,7 @@
 #include <xmlwrapp/init.h>
 #include <xmlwrapp/tree_parser.h>
 
+#include <fstream>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
@@ -41,6 +44,9 @@ namespace xml_lmi
 {
 /// Parse an xml file.
 ///
+/// A gzip-compressed file is decompressed first, so that the caller
+/// needn't care how the file was stored.
+///
 /// Precondition: argument names an accessible xml file.
 ///
 /// Postconditions: member parser_ is valid.
@@ -62,7 +68,16 @@ xml_lmi::dom_parser::dom_parser(std::string const& filename)
             {
             throw std::runtime_error("File does not exist.");
             }
-        parser_.reset(new DomParser(filename.c_str()));
+        std::ifstream ifs(filename.c_str(), ios_in_binary());
+        if(is_gzip_compressed(ifs))
+            {
+            std::string const s(gunzip(ifs));
+            parser_.reset(new DomParser(s.c_str(), s.size()));
+            }
+        else
+            {
+            parser_.reset(new DomParser(filename.c_str()));
+            }
         }
     catch(std::exception const& e)
         {
@@ -99,7 +114,8 @@ xml_lmi::dom_parser::dom_parser(char const* data, std::size_t length)
 ///   xml::tree_parser(std::istream&)
 /// Therefore, read the std::istream into a std::string with
 /// istream_to_string(), and pass that to the xml::tree_parser ctor
-/// that takes a char* and a byte count.
+/// that takes a char* and a byte count. A gzip-compressed stream is
+/// decompressed into that string instead.
 ///
 /// Precondition: argument is an xml stream for which 0 == rdstate().
 ///
@@ -119,7 +135,14 @@ xml_lmi::dom_parser::dom_parser(std::istream const& is)
             throw std::runtime_error("Stream state is not 'good'.");
             }
         std::string s;
-        istream_to_string(is, s);
+        if(is_gzip_compressed(is))
+            {
+            s = gunzip(is);
+            }
+        else
+            {
+            istream_to_string(is, s);
+            }
         parser_.reset(new DomParser(s.c_str(), 1 + s.size()));
         }
     catch(std::exception const& e)
@@ -32,6 +32,8 @@
 #include <list>
 #include <map>
 #include <string>
+#include <utility>                      // std::pair
+#include <vector>
 
 /// Type of a deserialized xml element.
 ///
@@ -48,6 +50,18 @@ struct deserialized
 ///
 /// Implicitly-declared special member functions do the right thing.
 
+/// An xml element as a streaming parser sees it: its name, its
+/// "version" attribute if it has one, and the name and text content
+/// of each subelement, in document order.
+
+struct flat_xml_element
+{
+    std::string                                     name;
+    bool                                            has_version {false};
+    std::string                                     version;
+    std::vector<std::pair<std::string,std::string>> subelements;
+};
+
 template<typename T>
 class LMI_SO xml_serializable
 {
@@ -60,13 +74,17 @@ class LMI_SO xml_serializable
     void save(fs::path const&) const;
 
     void read (xml::element const&);
+    void read (flat_xml_element const&);
     void write(xml::element&) const;
 
   private:
+    class member_tally;
+
     // Private non-virtuals.
     T      & t()      ;
     T const& t() const;
     void immit_members_into(xml::element&) const;
+    void check_root_name(std::string const&) const;
 
     // Class (T) identification.
 
@@ -25,14 +25,15 @@
 #include "any_member.hpp"               // MemberSymbolTable<>
 #include "contains.hpp"
 #include "platform_dependent.hpp"       // access()
+#include "value_cast.hpp"
 #include "xml_lmi.hpp"
 
 #include <boost/filesystem/convenience.hpp> // basename()
 
 #include <xmlwrapp/nodes_view.h>
 
-#include <algorithm>                    // std::copy(), std::find()
-#include <iterator>                     // std::back_inserter()
+#include <algorithm>                    // std::binary_search(), std::lower_bound()
+#include <cstddef>                      // std::size_t
 #include <sstream>
 #include <type_traits>
 #include <vector>
@@ -74,21 +75,87 @@ void xml_serializable<T>::save(fs::path const& path) const
     document.save(path.string());
 }
 
+template<typename X, typename Y>
+inline Y sfinae_cast
+    (X const& x
+    ,typename std::enable_if<std::is_same<X,Y>::value>::type* = nullptr
+    )
+{
+    return x;
+}
+
+template<typename X, typename Y>
+inline Y sfinae_cast
+    (X const&
+    ,typename std::enable_if<!std::is_same<X,Y>::value>::type* = nullptr
+    )
+{
+    alarum() << "Impermissible type conversion." << LMI_FLUSH;
+    return Y();
+}
+
+/// Members not yet read while reading an xml element.
+///
+/// Member names are sorted, so each subelement's name is found by
+/// binary search, instead of by searching a list of residuary names.
+
 template<typename T>
-void xml_serializable<T>::read(xml::element const& x)
+class xml_serializable<T>::member_tally
 {
-    if(xml_root_name() != x.get_name())
+  public:
+    explicit member_tally(std::vector<std::string> const& names)
+        :names_ (names)
+        ,read_  (names.size(), false)
+        {}
+
+    /// Mark the named member as read, iff it exists and hasn't yet
+    /// been read; return true iff it was so marked.
+
+    bool take(std::string const& name)
         {
-        alarum()
-            << "XML node name is '"
-            << x.get_name()
-            << "' but '"
-            << xml_root_name()
-            << "' was expected."
-            << LMI_FLUSH
-            ;
+        auto const i = std::lower_bound(names_.begin(), names_.end(), name);
+        if(names_.end() == i || name != *i)
+            {
+            return false;
+            }
+        std::vector<bool>::reference r = read_[i - names_.begin()];
+        bool const z = !r;
+        r = true;
+        return z;
+        }
+
+    /// Describe a discarded subelement, for a diagnostic.
+
+    std::string describe(std::string const& name) const
+        {
+        bool b = std::binary_search(names_.begin(), names_.end(), name);
+        std::string s = b ? "[duplicate]" : "[unrecognized]";
+        return "  '" + name + "' " + s + "\n";
         }
 
+    std::list<std::string> residuary_names() const
+        {
+        std::list<std::string> z;
+        for(std::size_t j = 0; j < names_.size(); ++j)
+            {
+            if(!read_[j])
+                {
+                z.push_back(names_[j]);
+                }
+            }
+        return z;
+        }
+
+  private:
+    std::vector<std::string> const& names_;
+    std::vector<bool>               read_;
+};
+
+template<typename T>
+void xml_serializable<T>::read(xml::element const& x)
+{
+    check_root_name(x.get_name());
+
     int file_version = 0;
     if(!xml_lmi::get_attr(x, "version", file_version))
         {
@@ -99,25 +166,14 @@ void xml_serializable<T>::read(xml::element const& x)
 
     std::map<std::string,value_type> detritus_map;
 
-    std::list<std::string> residuary_names;
-    std::copy
-        (t().member_names().begin()
-        ,t().member_names().end()
-        ,std::back_inserter(residuary_names)
-        );
+    member_tally tally(t().member_names());
 
     for(auto const& child : x.elements())
         {
         std::string node_tag(child.get_name());
-        std::list<std::string>::iterator current_member = std::find
-            (residuary_names.begin()
-            ,residuary_names.end()
-            ,node_tag
-            );
-        if(residuary_names.end() != current_member)
+        if(tally.take(node_tag))
             {
             read_element(child, node_tag, file_version);
-            residuary_names.erase(current_member);
             }
         else if(is_detritus(node_tag))
             {
@@ -128,9 +184,7 @@ void xml_serializable<T>::read(xml::element const& x)
             }
         else
             {
-            bool b = contains(t().member_names(), node_tag);
-            std::string s = b ? "[duplicate]" : "[unrecognized]";
-            oss << "  '" << node_tag << "' " << s << "\n";
+            oss << tally.describe(node_tag);
             }
         }
     if(!oss.str().empty())
@@ -138,7 +192,68 @@ void xml_serializable<T>::read(xml::element const& x)
         warning() << "Discarded XML elements:\n" << oss.str() << LMI_FLUSH;
         }
 
-    redintegrate_ex_post(file_version, detritus_map, residuary_names);
+    redintegrate_ex_post(file_version, detritus_map, tally.residuary_names());
+
+    redintegrate_ad_terminum();
+}
+
+/// Read an element that a streaming parser has already flattened.
+///
+/// This has the same effect as reading the equivalent xml::element,
+/// including all redintegration, provided that class T overrides
+/// neither fetch_element() nor read_element(), whose arguments are
+/// DOM nodes; that precondition holds for class Input, for which
+/// this is used to read '.ill' and '.cns' files without building a
+/// DOM.
+
+template<typename T>
+void xml_serializable<T>::read(flat_xml_element const& x)
+{
+    check_root_name(x.name);
+
+    int file_version = 0;
+    if(x.has_version)
+        {
+        file_version = value_cast<int>(x.version);
+        }
+    else
+        {
+        handle_missing_version_attribute();
+        }
+
+    std::ostringstream oss;
+
+    std::map<std::string,value_type> detritus_map;
+
+    member_tally tally(t().member_names());
+
+    for(auto const& child : x.subelements)
+        {
+        std::string const& node_tag(child.first);
+        if(tally.take(node_tag))
+            {
+            value_type v = sfinae_cast<std::string,value_type>(child.second);
+            redintegrate_ex_ante(file_version, node_tag, v);
+            t()[node_tag] = sfinae_cast<value_type,std::string>(v);
+            }
+        else if(is_detritus(node_tag))
+            {
+            // Hold certain obsolete entities that must be translated.
+            value_type v = sfinae_cast<std::string,value_type>(child.second);
+            redintegrate_ex_ante(file_version, node_tag, v);
+            detritus_map[node_tag] = v;
+            }
+        else
+            {
+            oss << tally.describe(node_tag);
+            }
+        }
+    if(!oss.str().empty())
+        {
+        warning() << "Discarded XML elements:\n" << oss.str() << LMI_FLUSH;
+        }
+
+    redintegrate_ex_post(file_version, detritus_map, tally.residuary_names());
 
     redintegrate_ad_terminum();
 }
@@ -184,23 +299,20 @@ void xml_serializable<T>::immit_members_into(xml::element& root) const
         }
 }
 
-template<typename X, typename Y>
-inline Y sfinae_cast
-    (X const& x
-    ,typename std::enable_if<std::is_same<X,Y>::value>::type* = nullptr
-    )
-{
-    return x;
-}
-
-template<typename X, typename Y>
-inline Y sfinae_cast
-    (X const&
-    ,typename std::enable_if<!std::is_same<X,Y>::value>::type* = nullptr
-    )
+template<typename T>
+void xml_serializable<T>::check_root_name(std::string const& name) const
 {
-    alarum() << "Impermissible type conversion." << LMI_FLUSH;
-    return Y();
+    if(xml_root_name() != name)
+        {
+        alarum()
+            << "XML node name is '"
+            << name
+            << "' but '"
+            << xml_root_name()
+            << "' was expected."
+            << LMI_FLUSH
+            ;
+        }
 }
 
 /// Retrieve an xml element's value.